@@ -6,23 +6,41 @@
 #include <onlmon/HistoBinDefs.h>
 #include <onlmon/OnlMonBase.h>  // for OnlMonBase
 #include <onlmon/OnlMonDefs.h>
+#include <onlmon/OnlMonRegistry.h>
+#include <onlmon/OnlMonShm.h>
 
 #include <MessageTypes.h>  // for kMESS_STRING, kMESS_OBJECT
+#include <TArray.h>
+#include <TAxis.h>
+#include <TBox.h>
 #include <TCanvas.h>
+#include <TClass.h>
 #include <TDirectory.h>
+#include <TF1.h>
 #include <TFile.h>
 #include <TGClient.h>  // for gClient, TGClient
 #include <TGFrame.h>
+#include <TGraph.h>
 #include <TH1.h>
+#include <THStack.h>
 #include <TImage.h>
+#include <TKey.h>
 #include <TIterator.h>
+#include <TLegend.h>
+#include <TLegendEntry.h>
+#include <TLine.h>
 #include <TList.h>  // for TList
+#include <TMarker.h>
 #include <TMessage.h>
+#include <TMultiGraph.h>
+#include <TPad.h>
+#include <TPaveText.h>
 #include <TROOT.h>
 #include <TSeqCollection.h>
 #include <TSocket.h>
 #include <TStyle.h>
 #include <TSystem.h>
+#include <TText.h>
 
 #include <odbc++/connection.h>
 #include <odbc++/drivermanager.h>
@@ -32,19 +50,350 @@
 
 #include <sys/stat.h>
 #include <sys/utsname.h>
+#include <sys/wait.h>
 #include <unistd.h>
-#include <uuid/uuid.h>
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
 #include <cstdio>   // for printf, remove
 #include <cstdlib>  // for getenv, exit
 #include <cstring>  // for strcmp
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <list>
 #include <sstream>
+#include <thread>
 #include <utility>  // for pair
 
+namespace
+{
+  // FNV-1a, stable across processes (unlike TObject::Hash which uses the address)
+  void hashBytes(uint64_t &hash, const void *data, const size_t size)
+  {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ULL;
+    }
+  }
+
+  void hashString(uint64_t &hash, const std::string &str)
+  {
+    hashBytes(hash, str.data(), str.size());
+  }
+
+  template <typename T>
+  void hashValue(uint64_t &hash, const T value)
+  {
+    hashBytes(hash, &value, sizeof(value));
+  }
+
+  // colors and styles, pads showing a status only by color change with them
+  void hashAttributes(uint64_t &hash, TObject *obj)
+  {
+    if (TAttFill *fill = dynamic_cast<TAttFill *>(obj))
+    {
+      hashValue(hash, fill->GetFillColor());
+      hashValue(hash, fill->GetFillStyle());
+    }
+    if (TAttLine *line = dynamic_cast<TAttLine *>(obj))
+    {
+      hashValue(hash, line->GetLineColor());
+      hashValue(hash, line->GetLineStyle());
+      hashValue(hash, line->GetLineWidth());
+    }
+    if (TAttMarker *marker = dynamic_cast<TAttMarker *>(obj))
+    {
+      hashValue(hash, marker->GetMarkerColor());
+      hashValue(hash, marker->GetMarkerStyle());
+      hashValue(hash, marker->GetMarkerSize());
+    }
+    if (TAttText *text = dynamic_cast<TAttText *>(obj))
+    {
+      hashValue(hash, text->GetTextColor());
+      hashValue(hash, text->GetTextSize());
+    }
+  }
+
+  void hashAxis(uint64_t &hash, TAxis *axis)
+  {
+    hashValue(hash, axis->GetFirst());
+    hashValue(hash, axis->GetLast());
+    hashValue(hash, axis->GetXmin());
+    hashValue(hash, axis->GetXmax());
+  }
+
+  void hashFunction(uint64_t &hash, TF1 *func)
+  {
+    hashValue(hash, func->GetXmin());
+    hashValue(hash, func->GetXmax());
+    hashValue(hash, func->GetNpx());
+    hashBytes(hash, func->GetParameters(), func->GetNpar() * sizeof(double));
+  }
+
+  // fits and stats boxes attached to a histogram or graph
+  void hashFunctions(uint64_t &hash, TList *functions)
+  {
+    if (!functions)
+    {
+      return;
+    }
+    TIter next(functions);
+    while (TObject *obj = next())
+    {
+      hashString(hash, obj->ClassName());
+      hashString(hash, obj->GetName());
+      hashAttributes(hash, obj);
+      if (TF1 *func = dynamic_cast<TF1 *>(obj))
+      {
+        hashFunction(hash, func);
+      }
+      else if (TPaveText *pave = dynamic_cast<TPaveText *>(obj))
+      {
+        TIter nextline(pave->GetListOfLines());
+        while (TObject *paveline = nextline())
+        {
+          hashString(hash, paveline->GetTitle());
+        }
+      }
+    }
+  }
+
+  void hashHisto(uint64_t &hash, TH1 *histo)
+  {
+    hashValue(hash, histo->GetEntries());
+    hashValue(hash, histo->GetMinimumStored());
+    hashValue(hash, histo->GetMaximumStored());
+    hashAxis(hash, histo->GetXaxis());
+    hashAxis(hash, histo->GetYaxis());
+    hashAxis(hash, histo->GetZaxis());
+    for (int i = 0; i < histo->GetNcells(); i++)
+    {
+      hashValue(hash, histo->GetBinContent(i));
+    }
+    hashFunctions(hash, histo->GetListOfFunctions());
+  }
+
+  void hashGraph(uint64_t &hash, TGraph *graph)
+  {
+    hashValue(hash, graph->GetN());
+    hashBytes(hash, graph->GetX(), graph->GetN() * sizeof(double));
+    hashBytes(hash, graph->GetY(), graph->GetN() * sizeof(double));
+    hashValue(hash, graph->GetMinimum());
+    hashValue(hash, graph->GetMaximum());
+    hashFunctions(hash, graph->GetListOfFunctions());
+  }
+
+  // hash of everything drawn into a pad: histogram contents and axis ranges,
+  // graph points, texts (run number, event time), positions of lines and
+  // boxes, draw options, colors and the names/titles of everything else
+  void hashPad(uint64_t &hash, TPad *pad)
+  {
+    hashValue(hash, pad->GetWw());
+    hashValue(hash, pad->GetWh());
+    hashValue(hash, pad->GetFillColor());
+    hashValue(hash, pad->GetLogx());
+    hashValue(hash, pad->GetLogy());
+    hashValue(hash, pad->GetLogz());
+    hashValue(hash, pad->GetGridx());
+    hashValue(hash, pad->GetGridy());
+    TIter next(pad->GetListOfPrimitives());
+    while (TObject *obj = next())
+    {
+      hashString(hash, obj->ClassName());
+      hashString(hash, obj->GetName());
+      hashString(hash, obj->GetTitle());
+      Option_t *option = next.GetOption();
+      hashString(hash, (option) ? option : "");
+      hashAttributes(hash, obj);
+      if (TPad *subpad = dynamic_cast<TPad *>(obj))
+      {
+        hashPad(hash, subpad);
+      }
+      else if (TH1 *histo = dynamic_cast<TH1 *>(obj))
+      {
+        hashHisto(hash, histo);
+      }
+      else if (TGraph *graph = dynamic_cast<TGraph *>(obj))
+      {
+        hashGraph(hash, graph);
+      }
+      else if (THStack *stack = dynamic_cast<THStack *>(obj))
+      {
+        TIter nexthisto(stack->GetHists());
+        while (TObject *member = nexthisto())
+        {
+          hashAttributes(hash, member);
+          hashHisto(hash, static_cast<TH1 *>(member));
+        }
+      }
+      else if (TMultiGraph *multigraph = dynamic_cast<TMultiGraph *>(obj))
+      {
+        TIter nextgraph(multigraph->GetListOfGraphs());
+        while (TObject *member = nextgraph())
+        {
+          hashAttributes(hash, member);
+          hashGraph(hash, static_cast<TGraph *>(member));
+        }
+      }
+      else if (TF1 *func = dynamic_cast<TF1 *>(obj))
+      {
+        hashFunction(hash, func);
+      }
+      else if (TLine *line = dynamic_cast<TLine *>(obj))
+      {
+        hashValue(hash, line->GetX1());
+        hashValue(hash, line->GetY1());
+        hashValue(hash, line->GetX2());
+        hashValue(hash, line->GetY2());
+      }
+      else if (TBox *box = dynamic_cast<TBox *>(obj))
+      {
+        // TPave (TPaveText, TLegend) are boxes as well
+        hashValue(hash, box->GetX1());
+        hashValue(hash, box->GetY1());
+        hashValue(hash, box->GetX2());
+        hashValue(hash, box->GetY2());
+        if (TPaveText *pave = dynamic_cast<TPaveText *>(obj))
+        {
+          TIter nextline(pave->GetListOfLines());
+          while (TObject *paveline = nextline())
+          {
+            hashString(hash, paveline->GetTitle());
+            hashAttributes(hash, paveline);
+          }
+        }
+        else if (TLegend *legend = dynamic_cast<TLegend *>(obj))
+        {
+          TIter nextentry(legend->GetListOfPrimitives());
+          while (TObject *entry = nextentry())
+          {
+            if (TLegendEntry *legendentry = dynamic_cast<TLegendEntry *>(entry))
+            {
+              hashString(hash, legendentry->GetLabel());
+              hashString(hash, legendentry->GetOption());
+            }
+            hashAttributes(hash, entry);
+          }
+        }
+      }
+      else if (TText *text = dynamic_cast<TText *>(obj))
+      {
+        hashValue(hash, text->GetX());
+        hashValue(hash, text->GetY());
+      }
+      else if (TMarker *marker = dynamic_cast<TMarker *>(obj))
+      {
+        hashValue(hash, marker->GetX());
+        hashValue(hash, marker->GetY());
+      }
+    }
+  }
+
+  // HistoMap.save: "OMHM", version, then per monitor its host, port,
+  // generation and histograms (length prefixed strings)
+  const char HISTOMAPMAGIC[4] = {'O', 'M', 'H', 'M'};
+  const uint32_t HISTOMAPVERSION = 1;
+
+  template <typename T>
+  void writeValue(std::ostream &os, const T value)
+  {
+    os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  template <typename T>
+  bool readValue(std::istream &is, T &value)
+  {
+    return static_cast<bool>(is.read(reinterpret_cast<char *>(&value), sizeof(value)));
+  }
+
+  void writeString(std::ostream &os, const std::string &str)
+  {
+    writeValue(os, static_cast<uint32_t>(str.size()));
+    os.write(str.data(), str.size());
+  }
+
+  bool readString(std::istream &is, std::string &str)
+  {
+    uint32_t len = 0;
+    if (!readValue(is, len) || len > OnlMonDefs::MSGLEN)
+    {
+      return false;
+    }
+    str.resize(len);
+    return static_cast<bool>(is.read(&str[0], len));
+  }
+
+  std::string hashFileName(const std::string &pngfilename)
+  {
+    std::filesystem::path hashfile(pngfilename);
+    hashfile.replace_filename("." + hashfile.filename().string() + ".hash");
+    return hashfile.string();
+  }
+
+  std::string thumbnailName(const std::string &pngfilename)
+  {
+    std::filesystem::path thumbname(pngfilename);
+    thumbname.replace_filename(thumbname.stem().string() + "_thumb" + thumbname.extension().string());
+    return thumbname.string();
+  }
+
+  // reads the newest cycle of all histograms of a file, safe to run in
+  // parallel threads (with ROOT::EnableThreadSafety()) since it does not
+  // touch the client maps. The file is returned (not closed), nullptr
+  // if it could not be opened
+  TFile *readHistoFile(const std::string &filename, std::vector<TH1 *> &histos)
+  {
+    std::cout << "Reading histos from " << filename << std::endl;
+    TFile *histofile = TFile::Open(filename.c_str(), "READ");
+    if (!histofile)
+    {
+      return nullptr;
+    }
+    std::map<std::string, TKey *> newestkeys;
+    TIter next(histofile->GetListOfKeys());
+    while (TKey *key = static_cast<TKey *>(next()))
+    {
+      auto keyiter = newestkeys.find(key->GetName());
+      if (keyiter == newestkeys.end() || keyiter->second->GetCycle() < key->GetCycle())
+      {
+        newestkeys[key->GetName()] = key;
+      }
+    }
+    for (auto &keyiter : newestkeys)
+    {
+      TObject *obj = keyiter.second->ReadObj();
+      TH1 *histo = dynamic_cast<TH1 *>(obj);
+      if (!histo)
+      {
+        delete obj;
+        continue;
+      }
+      // disconnect the histo from the TFile
+      histo->SetDirectory(nullptr);
+      histos.push_back(histo);
+    }
+    return histofile;
+  }
+
+  // threads of this process, 0 if the kernel does not tell
+  unsigned int RunningThreads()
+  {
+    std::error_code ec;
+    unsigned int nthreads = 0;
+    for (std::filesystem::directory_iterator task("/proc/self/task", ec), end; !ec && task != end; task.increment(ec))
+    {
+      nthreads++;
+    }
+    return (ec) ? 0 : nthreads;
+  }
+}  // namespace
+
 OnlMonClient *OnlMonClient::__instance = nullptr;
 
 int pinit()
@@ -140,6 +489,10 @@ OnlMonClient::~OnlMonClient()
     delete Histo.begin()->second;
     Histo.erase(Histo.begin());
   }
+  for (auto &shmiter : m_ShmSegments)
+  {
+    delete shmiter.second;
+  }
   delete clientrunning;
   delete fHtml;
   delete defaultStyle;
@@ -207,7 +560,7 @@ void OnlMonClient::registerHisto(const std::string &hname, const std::string &su
   return;
 }
 
-int OnlMonClient::requestHistoBySubSystem(const std::string &subsys, int getall)
+int OnlMonClient::requestHistoBySubSystem(const std::string &subsys, int getall, const std::set<std::string> *hnames)
 {
   std::string mysubsys = subsys.substr(0, subsys.find('_'));
   for (const auto &frwrkiter : m_MonitorFetchedSet)
@@ -218,6 +571,11 @@ int OnlMonClient::requestHistoBySubSystem(const std::string &subsys, int getall)
       break;
     }
   }
+  if (m_CacheOnly)
+  {
+    m_MonitorFetchedSet.insert(subsys);
+    return 0;
+  }
   int iret = 0;
   std::map<const std::string, ClientHistoList *>::const_iterator histoiter;
   std::map<const std::string, ClientHistoList *>::const_iterator histonewiter;
@@ -255,6 +613,10 @@ int OnlMonClient::requestHistoBySubSystem(const std::string &subsys, int getall)
     std::map<std::string, std::map<const std::string, ClientHistoList *>>::const_iterator histos = SubsysHisto.find(subsys);
     for (auto &hiter : histos->second)
     {
+      if (hnames && hnames->find(hiter.first) == hnames->end())
+      {
+        continue;
+      }
       if (requestHistoByName(subsys, hiter.first))
       {
         if (Verbosity() > 2)
@@ -286,6 +648,10 @@ int OnlMonClient::requestHistoBySubSystem(const std::string &subsys, int getall)
         {
           std::cout << "checking for subsystem " << subs->first << ", histo " << histos.first << std::endl;
         }
+        if (hnames && hnames->find(histos.first) == hnames->end())
+        {
+          continue;  // not needed now, keep what we have
+        }
         if (histos.second->SubSystem() == subsys)
         {
           int unknown_histo = 0;
@@ -340,6 +706,14 @@ int OnlMonClient::requestHistoBySubSystem(const std::string &subsys, int getall)
         }
         continue;
       }
+      if (m_UseSharedMemory && OnlMonRegistry::SameHost(hostportiter->second.first, "localhost"))
+      {
+        ReadSharedMemory(listiter.first, hostportiter->second.second, hlist);
+        if (hlist.empty())
+        {
+          continue;
+        }
+      }
       if (requestHistoList(listiter.first, hostportiter->second.first, hostportiter->second.second, hlist) != 0)
       {
         for (liter = hlist.begin(); liter != hlist.end(); ++liter)
@@ -419,6 +793,230 @@ int OnlMonClient::requestHistoBySubSystem(const std::string &subsys, int getall)
   return iret;
 }
 
+int OnlMonClient::requestHistoForCanvas(const std::string &drawername, const std::string &what)
+{
+  OnlMonDraw *drawer = GetDrawer(drawername);
+  if (!drawer)
+  {
+    return -1;
+  }
+  int iret = 0;
+  // summed histograms come from the aggregator while it runs, the servers do not need to send their copies
+  std::set<std::string> merged;
+  bool aggregated = false;
+  if (!drawer->Aggregator().empty() && drawer->MergedCanvasHistos(what, merged))
+  {
+    // looking for one which does not run scans all hosts and ports, not on every draw
+    auto missediter = m_AggregatorMissed.find(drawer->Aggregator());
+    if (missediter == m_AggregatorMissed.end() || time(nullptr) - missediter->second >= AGGREGATORRETRY)
+    {
+      std::set<std::string> aggnames = merged;
+      aggnames.insert("FrameWorkVars");
+      iret += requestHistoBySubSystem(drawer->Aggregator(), 1, &aggnames);
+      aggregated = (MonitorHostPorts.find(drawer->Aggregator()) != MonitorHostPorts.end());
+      if (aggregated)
+      {
+        m_AggregatorMissed.erase(drawer->Aggregator());
+      }
+      else
+      {
+        m_AggregatorMissed[drawer->Aggregator()] = time(nullptr);
+      }
+    }
+  }
+  for (auto server = drawer->ServerBegin(); server != drawer->ServerEnd(); ++server)
+  {
+    std::set<std::string> hnames;
+    if (what == "ALL" || !drawer->CanvasHistos(what, *server, hnames))
+    {
+      auto subsysiter = SubsysHisto.find(*server);
+      if (!aggregated || subsysiter == SubsysHisto.end())
+      {
+        iret += requestHistoBySubSystem(*server, 1);
+        continue;
+      }
+      for (auto &histos : subsysiter->second)
+      {
+        hnames.insert(histos.first);
+      }
+    }
+    for (auto &hname : merged)
+    {
+      if (aggregated)
+      {
+        hnames.erase(hname);
+      }
+      else
+      {
+        hnames.insert(hname);
+      }
+    }
+    hnames.insert("FrameWorkVars");  // run number, event time, server stats
+    if (Verbosity() > 1)
+    {
+      std::cout << __PRETTY_FUNCTION__ << " fetching " << hnames.size() << " histograms of "
+                << *server << " for " << what << std::endl;
+    }
+    iret += requestHistoBySubSystem(*server, 1, &hnames);
+  }
+  return iret;
+}
+
+int OnlMonClient::PrepareTransfer(const std::string &drawername, std::vector<HistoTransfer> &transfers, const std::string &what)
+{
+  auto drawiter = DrawerList.find(drawername);
+  if (drawiter == DrawerList.end())
+  {
+    return -1;
+  }
+  OnlMonDraw *drawer = drawiter->second;
+  // the summed histograms are taken from the aggregator if we know where it runs
+  std::set<std::string> merged;
+  bool aggregated = false;
+  if (!drawer->Aggregator().empty() && drawer->MergedCanvasHistos(what, merged))
+  {
+    auto hostportiter = MonitorHostPorts.find(drawer->Aggregator());
+    auto subsysiter = SubsysHisto.find(drawer->Aggregator());
+    if (hostportiter != MonitorHostPorts.end() && subsysiter != SubsysHisto.end())
+    {
+      HistoTransfer transfer;
+      transfer.subsys = drawer->Aggregator();
+      transfer.hostname = hostportiter->second.first;
+      transfer.port = hostportiter->second.second;
+      for (auto &histos : subsysiter->second)
+      {
+        if (histos.first == "FrameWorkVars" || merged.find(histos.first) != merged.end())
+        {
+          transfer.hnames.push_back(drawer->Aggregator() + ' ' + histos.first);
+        }
+      }
+      transfers.push_back(transfer);
+      aggregated = true;
+    }
+  }
+  for (auto server = drawer->ServerBegin(); server != drawer->ServerEnd(); ++server)
+  {
+    auto hostportiter = MonitorHostPorts.find(*server);
+    auto subsysiter = SubsysHisto.find(*server);
+    if (hostportiter == MonitorHostPorts.end() || subsysiter == SubsysHisto.end())
+    {
+      return -1;
+    }
+    std::set<std::string> hnames;
+    bool canvasonly = (what != "ALL" && drawer->CanvasHistos(what, *server, hnames));
+    if (!aggregated)
+    {
+      hnames.insert(merged.begin(), merged.end());
+    }
+    HistoTransfer transfer;
+    transfer.subsys = *server;
+    transfer.hostname = hostportiter->second.first;
+    transfer.port = hostportiter->second.second;
+    for (auto &histos : subsysiter->second)
+    {
+      if (histos.first != "FrameWorkVars")
+      {
+        if (aggregated && merged.find(histos.first) != merged.end())
+        {
+          continue;
+        }
+        if (canvasonly && hnames.find(histos.first) == hnames.end())
+        {
+          continue;
+        }
+      }
+      transfer.hnames.push_back(*server + ' ' + histos.first);
+    }
+    transfers.push_back(transfer);
+  }
+  return 0;
+}
+
+int OnlMonClient::TransferHistos(HistoTransfer &transfer, const int timeout_ms, std::atomic<int> *nreceived)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  // wait for the answer of the server, but not longer than the deadline
+  auto answered = [&deadline](TSocket &sock)
+  {
+    long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    return remaining > 0 && sock.Select(TSocket::kRead, remaining) > 0;
+  };
+  TSocket sock(transfer.hostname.c_str(), transfer.port);
+  if (!sock.IsValid())
+  {
+    transfer.status = -1;
+    return transfer.status;
+  }
+  TMessage *mess = nullptr;
+  sock.Send("LIST");
+  if (!answered(sock))
+  {
+    transfer.status = -2;
+    sock.Close();
+    return transfer.status;
+  }
+  sock.Recv(mess);  // "go"
+  if (!mess)
+  {
+    transfer.status = -1;
+    sock.Close();
+    return transfer.status;
+  }
+  delete mess;
+  for (auto &hname : transfer.hnames)
+  {
+    sock.Send(hname.c_str());
+    if (!answered(sock))
+    {
+      transfer.status = -2;
+      break;
+    }
+    mess = nullptr;
+    sock.Recv(mess);
+    if (!mess)
+    {
+      transfer.status = -1;
+      break;
+    }
+    if (mess->What() == kMESS_OBJECT)
+    {
+      transfer.received.push_back(std::make_pair(hname.substr(hname.find(' ') + 1), mess));
+      if (nreceived)
+      {
+        (*nreceived)++;
+      }
+      continue;
+    }
+    delete mess;  // "UnknownHisto"
+  }
+  if (transfer.status == 0)
+  {
+    sock.Send("alldone");
+    mess = nullptr;
+    sock.Recv(mess);  // "Finished"
+    delete mess;
+    sock.Send("Finished");
+  }
+  sock.Close();
+  return transfer.status;
+}
+
+int OnlMonClient::ReceiveTransfer(HistoTransfer &transfer)
+{
+  for (auto &recv : transfer.received)
+  {
+    TH1 *histo = ReceiveHisto(recv.second, transfer.subsys, recv.first);
+    delete recv.second;
+    if (verbosity > 1 && histo)
+    {
+      std::cout << __PRETTY_FUNCTION__ << "histoname: " << histo->GetName() << " at "
+                << histo << std::endl;
+    }
+  }
+  transfer.received.clear();
+  return transfer.status;
+}
+
 void OnlMonClient::registerDrawer(OnlMonDraw *Drawer)
 {
   std::map<const std::string, OnlMonDraw *>::iterator iter = DrawerList.find(Drawer->Name());
@@ -431,6 +1029,15 @@ void OnlMonClient::registerDrawer(OnlMonDraw *Drawer)
   {
     DrawerList[Drawer->Name()] = Drawer;
     Drawer->Init();
+    // the summed histograms of its canvases are requested from the aggregator
+    std::set<std::string> merged;
+    if (!Drawer->Aggregator().empty() && Drawer->MergedCanvasHistos("ALL", merged))
+    {
+      for (auto &hname : merged)
+      {
+        registerHisto(hname, Drawer->Aggregator());
+      }
+    }
     SetStyleToDefault();
   }
   return;
@@ -519,13 +1126,7 @@ int OnlMonClient::DoSomething(const std::string &who, const std::string &what, c
       }
       else if (opt == "HTML")
       {
-        if (verbosity > 0)
-        {
-          std::cout << __PRETTY_FUNCTION__ << " creating html output for "
-                    << iter->second->Name() << std::endl;
-        }
-        iter->second->isHtml(true);
-        if (iter->second->MakeHtml(what))
+        if (MakeHtmlDrawer(iter->second, what))
         {
           std::cout << "subsystem " << iter->second->Name()
                     << " not in root file, skipping" << std::endl;
@@ -548,6 +1149,27 @@ int OnlMonClient::DoSomething(const std::string &who, const std::string &what, c
   }
   else
   {
+    if (opt == "HTML" && m_HtmlWorkers > 1 && DrawerList.size() > 1)
+    {
+      // a forked worker of a threaded process inherits locks held by the other
+      // threads (ROOT, malloc) and must not draw or write anything
+      unsigned int nthreads = RunningThreads();
+      if (!gROOT->IsBatch())
+      {
+        std::cout << "parallel html output needs batch mode, running "
+                  << DrawerList.size() << " drawers sequentially" << std::endl;
+      }
+      else if (nthreads != 1)
+      {
+        std::cout << "parallel html output needs a single threaded client ("
+                  << nthreads << " threads running), running "
+                  << DrawerList.size() << " drawers sequentially" << std::endl;
+      }
+      else
+      {
+        return MakeHtmlParallel(what);
+      }
+    }
     for (iter = DrawerList.begin(); iter != DrawerList.end(); ++iter)
     {
       if (opt == "DRAW")
@@ -560,14 +1182,8 @@ int OnlMonClient::DoSomething(const std::string &who, const std::string &what, c
       }
       else if (opt == "HTML")
       {
-        if (verbosity > 0)
-        {
-          std::cout << __PRETTY_FUNCTION__ << " creating html output for "
-                    << iter->second->Name() << std::endl;
-        }
         gROOT->Reset();
-        iter->second->isHtml(true);
-        int iret = iter->second->MakeHtml(what);
+        int iret = MakeHtmlDrawer(iter->second, what);
         if (iret)
         {
           std::cout << "subsystem " << iter->second->Name()
@@ -590,6 +1206,201 @@ int OnlMonClient::DoSomething(const std::string &who, const std::string &what, c
   return 0;
 }
 
+// html output of one drawer, reports how long each of its png pages took
+int OnlMonClient::MakeHtmlDrawer(OnlMonDraw *drawer, const std::string &what)
+{
+  if (verbosity > 0)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " creating html output for "
+              << drawer->Name() << std::endl;
+  }
+  m_PageTimes.clear();
+  m_PageFiles.clear();
+  auto start = std::chrono::steady_clock::now();
+  // nothing is drawn if none of the histograms of the drawer changed since its pages were written
+  std::string inputhashfile;
+  uint64_t inputhash = 0xcbf29ce484222325ULL;
+  if (m_SkipUnchangedPages && HashDrawerInputs(drawer, what, inputhash))
+  {
+    std::string filename;
+    fHtml->namer(drawer->Name(), what, "inputs", inputhashfile, filename);
+    inputhashfile = hashFileName(inputhashfile);
+    std::vector<std::string> pages;
+    if (UnchangedPages(inputhashfile, inputhash, pages))
+    {
+      std::cout << drawer->Name() << " html output: histograms unchanged, keeping its "
+                << pages.size() << " pages" << std::endl;
+      return 0;
+    }
+  }
+  drawer->isHtml(true);
+  fHtml->beginMenu();  // menu files are written once after all pages are registered
+  int iret = drawer->MakeHtml(what);
+  fHtml->endMenu();
+  if (!inputhashfile.empty() && iret == 0 && !m_PageFiles.empty())
+  {
+    std::ofstream out(inputhashfile);
+    out << std::hex << inputhash << std::endl;
+    for (auto &page : m_PageFiles)
+    {
+      out << page << std::endl;
+    }
+  }
+  m_PageFiles.clear();
+  std::chrono::duration<double> total = std::chrono::steady_clock::now() - start;
+  double pagesum = 0;
+  for (auto &page : m_PageTimes)
+  {
+    pagesum += page.second;
+  }
+  std::ostringstream report;
+  report << std::fixed << std::setprecision(2);
+  report << drawer->Name() << " html output: " << m_PageTimes.size() << " pages in "
+         << total.count() << " s (drawing " << total.count() - pagesum << " s)" << std::endl;
+  for (auto &page : m_PageTimes)
+  {
+    report << "  " << page.first << " " << page.second << " s" << std::endl;
+  }
+  std::cout << report.str();
+  m_PageTimes.clear();
+  return iret;
+}
+
+// hash of the histograms we hold of the servers (and aggregator) of the
+// drawer, false if there are none to go by
+bool OnlMonClient::HashDrawerInputs(OnlMonDraw *drawer, const std::string &what, uint64_t &hash)
+{
+  std::set<std::string> servers(drawer->ServerBegin(), drawer->ServerEnd());
+  if (!drawer->Aggregator().empty())
+  {
+    servers.insert(drawer->Aggregator());
+  }
+  hashString(hash, what);
+  hashValue(hash, m_PngThumbnailWidth);
+  int nhistos = 0;
+  for (auto &server : servers)
+  {
+    hashString(hash, server);
+    auto subsysiter = SubsysHisto.find(server);
+    if (subsysiter == SubsysHisto.end())
+    {
+      continue;
+    }
+    for (auto &histos : subsysiter->second)
+    {
+      hashString(hash, histos.first);
+      TH1 *histo = histos.second->Histo();
+      hashValue(hash, (histo != nullptr));
+      if (histo)
+      {
+        hashAttributes(hash, histo);
+        hashHisto(hash, histo);
+        nhistos++;
+      }
+    }
+  }
+  return nhistos > 0;
+}
+
+// the drawer wrote its pages from the same histograms and they are all still there
+bool OnlMonClient::UnchangedPages(const std::string &inputhashfile, const uint64_t hash, std::vector<std::string> &pages)
+{
+  std::ifstream in(inputhashfile);
+  uint64_t oldhash = 0;
+  if (!(in >> std::hex >> oldhash) || oldhash != hash)
+  {
+    return false;
+  }
+  std::string page;
+  while (std::getline(in, page))
+  {
+    if (page.empty())
+    {
+      continue;  // rest of the hash line
+    }
+    if (!std::filesystem::exists(page) ||
+        (m_PngThumbnailWidth > 0 && !std::filesystem::exists(thumbnailName(page))))
+    {
+      return false;
+    }
+    pages.push_back(page);
+  }
+  return !pages.empty();
+}
+
+// fan the drawers out to forked worker processes. Every worker starts with
+// a copy of the histograms which were already fetched or read from file,
+// renders its drawer in its own ROOT state and exits. Only used in batch
+// mode since the workers must not share the connection to the X server, and
+// only while this process has no other threads (the file readers are joined,
+// the socket transfers are not running) since the workers do everything a
+// child of a threaded process must not do
+int OnlMonClient::MakeHtmlParallel(const std::string &what)
+{
+  std::map<pid_t, std::pair<std::string, std::chrono::steady_clock::time_point>> workers;
+  auto reap = [this, &workers]()
+  {
+    int status = 0;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid <= 0)
+    {
+      workers.clear();  // no children left, should not happen
+      return;
+    }
+    auto worker = workers.find(pid);
+    if (worker == workers.end())
+    {
+      return;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - worker->second.second;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      std::cout << "subsystem " << worker->second.first
+                << " not in root file or html worker failed, skipping" << std::endl;
+    }
+    else if (verbosity > 0)
+    {
+      std::cout << "html worker for " << worker->second.first << " done after "
+                << elapsed.count() << " s" << std::endl;
+    }
+    workers.erase(worker);
+  };
+
+  for (auto &iter : DrawerList)
+  {
+    while (workers.size() >= static_cast<unsigned int>(m_HtmlWorkers))
+    {
+      reap();
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+      std::cout << "could not fork html worker for " << iter.second->Name()
+                << ", doing it here: " << std::strerror(errno) << std::endl;
+      gROOT->Reset();
+      MakeHtmlDrawer(iter.second, what);
+      SetStyleToDefault();
+      continue;
+    }
+    if (pid == 0)
+    {
+      gROOT->Reset();
+      int iret = MakeHtmlDrawer(iter.second, what);
+      std::cout.flush();
+      // skip the exit handlers, they belong to the parent
+      _exit((iret) ? 1 : 0);
+    }
+    workers[pid] = std::make_pair(iter.second->Name(), std::chrono::steady_clock::now());
+  }
+  while (!workers.empty())
+  {
+    reap();
+  }
+  SetStyleToDefault();
+  return 0;
+}
+
 int OnlMonClient::requestHistoByName(const std::string &subsys, const std::string &what)
 {
   std::string hostname = "UNKNOWN";
@@ -693,17 +1504,13 @@ int OnlMonClient::requestHistoByName(const std::string &subsys, const std::strin
     }
     else if (mess->What() == kMESS_OBJECT)
     {
-      TH1 *histo = static_cast<TH1 *>(mess->ReadObjectAny(mess->GetClass()));
+      TH1 *histo = ReceiveHisto(mess, subsys, what);
       delete mess;
-      TH1 *maphist = static_cast<TH1 *>(histo->Clone(histo->GetName()));
-      if (verbosity > 1)
+      if (verbosity > 1 && histo)
       {
         std::cout << __PRETTY_FUNCTION__ << "histoname: " << histo->GetName() << " at "
                   << histo << std::endl;
       }
-
-      updateHistoMap(subsys, histo->GetName(), maphist);
-      delete histo;
       sock.Send("Ack");
     }
   }
@@ -879,16 +1686,15 @@ int OnlMonClient::requestHistoList(const std::string &subsys, const std::string
     }
     else if (mess->What() == kMESS_OBJECT)
     {
-      // this reads the message and allocate space for new histogram
-      TH1 *histo = static_cast<TH1 *>(mess->ReadObjectAny(mess->GetClass()));
+      // "<subsys> <histo>"
+      std::string hname = (*listiter).substr((*listiter).find(' ') + 1);
+      TH1 *histo = ReceiveHisto(mess, subsys, hname);
       delete mess;
-      if (verbosity > 1)
+      if (verbosity > 1 && histo)
       {
         std::cout << __PRETTY_FUNCTION__ << "histoname: " << histo->GetName() << " at "
                   << histo << std::endl;
       }
-
-      updateHistoMap(subsys, histo->GetName(), histo);
     }
   }
   sock.Send("alldone");
@@ -901,6 +1707,79 @@ int OnlMonClient::requestHistoList(const std::string &subsys, const std::string
   return 0;
 }
 
+int OnlMonClient::ReadSharedMemory(const std::string &subsys, const int port, std::list<std::string> &hlist)
+{
+  OnlMonShm *&shm = m_ShmSegments[port];
+  if (shm && !shm->IsCurrent())  // server was restarted
+  {
+    delete shm;
+    shm = nullptr;
+  }
+  if (!shm)
+  {
+    shm = OnlMonShm::Open(port);
+    if (!shm)
+    {
+      return 0;
+    }
+  }
+  int nread = 0;
+  auto liter = hlist.begin();
+  while (liter != hlist.end())
+  {
+    // "<subsys> <histo>"
+    std::string hname = liter->substr(liter->find(' ') + 1);
+    TMessage *mess = shm->Read(subsys, hname);
+    if (!mess)
+    {
+      ++liter;
+      continue;
+    }
+    ReceiveHisto(mess, subsys, hname);
+    delete mess;
+    liter = hlist.erase(liter);
+    nread++;
+  }
+  if (Verbosity() > 2)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " read " << nread << " histograms of " << subsys
+              << " from shared memory, " << hlist.size() << " left for the socket" << std::endl;
+  }
+  return nread;
+}
+
+TH1 *OnlMonClient::ReceiveHisto(TMessage *mess, const std::string &subsys, const std::string &hname)
+{
+  // a cached histogram of the same class is streamed over in place: the
+  // bin arrays are reused and the drawers keep their pointers. Only for
+  // the TArray based histograms, TH2Poly and friends own lists of bins
+  // which would pile up
+  TH1 *cached = getHisto(subsys, hname);
+  if (cached && mess->GetClass() == cached->IsA() && cached->IsA()->InheritsFrom(TArray::Class()))
+  {
+    UInt_t startpos = mess->Length();
+    UInt_t tag = 0;
+    TClass *cl = mess->ReadClass(cached->IsA(), &tag);
+    if (cl == cached->IsA())
+    {
+      cached->GetListOfFunctions()->Delete();  // streamed again
+      mess->MapObject(cached, cl, mess->GetMapCount());
+      cl->Streamer(cached, *mess);
+      mess->CheckByteCount(startpos, tag, cl);
+      return cached;
+    }
+    mess->SetBufferOffset(startpos);
+    mess->ResetMap();
+  }
+  // this reads the message and allocate space for new histogram
+  TH1 *histo = static_cast<TH1 *>(mess->ReadObjectAny(mess->GetClass()));
+  if (histo)
+  {
+    updateHistoMap(subsys, histo->GetName(), histo);
+  }
+  return histo;
+}
+
 void OnlMonClient::updateHistoMap(const std::string &subsys, const std::string &hname, TH1 *h1d)
 {
   auto subsysiter = SubsysHisto.find(subsys);
@@ -1243,6 +2122,11 @@ void OnlMonClient::AddServerHost(const std::string &hostname)
 
 int OnlMonClient::LocateHistogram(const std::string &hname, const std::string &subsys)
 {
+  int iret = LocateInRegistry(subsys, hname);
+  if (iret >= 0)
+  {
+    return iret;
+  }
   for (auto &hostiter : MonitorHosts)
   {
     if (UpdateServerHistoMap(hname, subsys, hostiter) > 0)
@@ -1399,46 +2283,70 @@ time_t OnlMonClient::EventTime(const std::string &servername, const std::string
 
 int OnlMonClient::ReadHistogramsFromFile(const std::string &filename, OnlMonDraw *drawer)
 {
-  std::string subsys = ExtractSubsystem(filename, drawer);
-  std::cout << "Reading histos from " << filename << std::endl;
-  TFile *histofile = TFile::Open(filename.c_str(), "READ");
-  if (!histofile)
+  return ReadHistogramsFromFiles(std::vector<std::string>(1, filename), drawer);
+}
+
+int OnlMonClient::ReadHistogramsFromFiles(const std::vector<std::string> &filenames, OnlMonDraw *drawer)
+{
+  // the client maps are not thread safe, subsystems are registered here
+  // and the histograms are put into the map after all files are read
+  std::vector<std::string> subsystems;
+  for (auto &filename : filenames)
   {
-    std::cout << "Can't open " << filename << std::endl;
-    return -1;
+    subsystems.push_back(ExtractSubsystem(filename, drawer));
   }
-  TIterator *titer = histofile->GetListOfKeys()->MakeIterator();
-  TObject *obj;
-  TH1 *histo, *histoptr;
-  while ((obj = titer->Next()))
+  std::vector<TFile *> histofiles(filenames.size(), nullptr);
+  std::vector<std::vector<TH1 *>> histos(filenames.size());
+  std::atomic<unsigned int> nextfile{0};
+  auto reader = [&]()
   {
-    if (verbosity > 0)
+    unsigned int ifile;
+    while ((ifile = nextfile++) < filenames.size())
+    {
+      histofiles[ifile] = readHistoFile(filenames[ifile], histos[ifile]);
+    }
+  };
+  unsigned int nthreads = std::min<unsigned int>(std::max(std::thread::hardware_concurrency(), 1U), filenames.size());
+  if (nthreads > 1)
+  {
+    ROOT::EnableThreadSafety();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < nthreads; i++)
+    {
+      threads.emplace_back(reader);
+    }
+    for (auto &thr : threads)
+    {
+      thr.join();
+    }
+  }
+  else
+  {
+    reader();
+  }
+  int iret = 0;
+  for (unsigned int ifile = 0; ifile < filenames.size(); ifile++)
+  {
+    if (!histofiles[ifile])
     {
-      std::cout << "TObject at " << obj << std::endl;
-      std::cout << obj->GetName() << std::endl;
-      std::cout << obj->ClassName() << std::endl;
+      std::cout << "Can't open " << filenames[ifile] << std::endl;
+      iret = -1;
+      continue;
     }
-    histofile->GetObject(obj->GetName(), histoptr);
-    if (histoptr)
+    for (auto histo : histos[ifile])
     {
-// this is hokey but it seems to work, the SetDirectory(0) disconnects
-// the histo from the TFile and the static cast makes it work with our
-// histomap (otherwise something throws an exception)
-      histoptr->SetDirectory(0);
-      histo = dynamic_cast<TH1 *>(histoptr);
-      updateHistoMap(subsys, histo->GetName(), histo);
+      updateHistoMap(subsystems[ifile], histo->GetName(), histo);
       if (verbosity > 0)
       {
         std::cout << "HistoName: " << histo->GetName() << std::endl;
         std::cout << "HistoClass: " << histo->ClassName() << std::endl;
       }
     }
+    // this is a fast way to close a file, if you call TFile->Close() it deletes all
+    // histograms which can take a really long time (hours)
+    gROOT->GetListOfFiles()->Remove(histofiles[ifile]);
   }
-  delete titer;
-// this is a fast way to close a file, if you call TFile->Close() it deletes all
-// histograms which can take a really long time (hours)
-  gROOT->GetListOfFiles()->Remove( histofile );
-  return 0;
+  return iret;
 }
 
 int OnlMonClient::SendCommand(const char *hostname, const int port, const char *cmd)
@@ -1526,11 +2434,6 @@ OnlMonClient::htmlRegisterPage(const OnlMonDraw &drawer,
 
 int OnlMonClient::CanvasToPng(TCanvas *canvas, std::string const &pngfilename)
 {
-  // in order not to collide when running multiple html generators
-  // create a unique filename (okay tempnam is not totally safe against
-  // multiple procs getting the same name but the local /tmp filesystem should
-  // prevent at least multiple machines colliding)
-  // returned char array needs to be free'd after use
   if (!canvas)
   {
     std::cout << __PRETTY_FUNCTION__ << " TCanvas is Null Pointer" << std::endl;
@@ -1542,24 +2445,16 @@ int OnlMonClient::CanvasToPng(TCanvas *canvas, std::string const &pngfilename)
               << canvas->GetName() << std::endl;
     return -1;
   }
-  uuid_t uu;
-  uuid_generate(uu);
-  char uuid[50];
-  uuid_unparse(uu, uuid);
-  std::string tmpname = "/tmp/TC" + std::string(uuid);
-  canvas->Print(tmpname.c_str(), "gif");  // write gif format
-  TImage *img = TImage::Open(tmpname.c_str());
-  img->WriteImage(pngfilename.c_str());
-  delete img;
-  if (remove(tmpname.c_str()))
-  {
-    std::cout << "Error removing " << tmpname << std::endl;
-  }
-  return 0;
+  auto start = std::chrono::steady_clock::now();
+  canvas->Update();
+  int iret = PadToPng(canvas, pngfilename);
+  AddPageTime(pngfilename, start, (iret > 0));
+  return (iret < 0) ? iret : 0;
 }
 
 int OnlMonClient::HistoToPng(TH1 *histo, std::string const &pngfilename, const char *drawopt, const int statopt)
 {
+  auto start = std::chrono::steady_clock::now();
   TCanvas *cgiCanv = new TCanvas("cgiCanv", "cgiCanv", 200, 200, 650, 500);
   gStyle->SetOptStat(statopt);
   cgiCanv->SetFillColor(0);
@@ -1573,22 +2468,94 @@ int OnlMonClient::HistoToPng(TH1 *histo, std::string const &pngfilename, const c
   histo->SetMarkerStyle(8);
   histo->SetMarkerSize(0.15);
   histo->Draw(drawopt);
-  uuid_t uu;
-  uuid_generate(uu);
-  char uuid[50];
-  uuid_unparse(uu, uuid);
-  std::string tmpname = "/tmp/TC" + std::string(uuid);
-  cgiCanv->Print(tmpname.c_str(), "gif");
-  TImage *img = TImage::Open(tmpname.c_str());
-  img->WriteImage(pngfilename.c_str());
-  if (remove(tmpname.c_str()))
-  {
-    std::cout << "Error removing " << tmpname << std::endl;
-  }
+  cgiCanv->Update();
+  int iret = PadToPng(cgiCanv, pngfilename);
   delete cgiCanv;
+  AddPageTime(pngfilename, start, (iret > 0));
+  return (iret < 0) ? iret : 0;
+}
+
+// rasterize the pad once in memory and encode it straight into the png
+// file (no more gif in /tmp which is then read back and converted).
+// If a thumbnail width is set, a scaled down copy of the same image goes
+// to <name>_thumb.png
+//
+// In html mode a hash of the pad content is kept in a hidden file next to
+// the png. If the png (and thumbnail) exist and the content did not change
+// since it was written (dead server, run ended) the rendering is skipped,
+// the menu entry was already registered by the drawer. Returns 1 then.
+int OnlMonClient::PadToPng(TPad *pad, const std::string &pngfilename)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  std::string hashfile;
+  if (make_html && m_SkipUnchangedPages)
+  {
+    hashPad(hash, pad);
+    hashValue(hash, m_PngThumbnailWidth);
+    hashfile = hashFileName(pngfilename);
+    std::ifstream in(hashfile);
+    uint64_t oldhash = 0;
+    if ((in >> std::hex >> oldhash) && oldhash == hash &&
+        std::filesystem::exists(pngfilename) &&
+        (m_PngThumbnailWidth == 0 || std::filesystem::exists(thumbnailName(pngfilename))))
+    {
+      if (verbosity > 1)
+      {
+        std::cout << pngfilename << " unchanged, not rendering it again" << std::endl;
+      }
+      return 1;
+    }
+  }
+  TImage *img = TImage::Create();
+  if (!img)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot create TImage, not saving "
+              << pngfilename << std::endl;
+    return -1;
+  }
+  img->FromPad(pad);
+  if (!img->IsValid())
+  {
+    std::cout << __PRETTY_FUNCTION__ << " could not rasterize " << pad->GetName()
+              << ", not saving " << pngfilename << std::endl;
+    delete img;
+    return -1;
+  }
+  img->WriteImage(pngfilename.c_str(), TImage::kPng);
+  if (m_PngThumbnailWidth > 0)
+  {
+    if (img->GetWidth() > m_PngThumbnailWidth)
+    {
+      unsigned int height = std::max(img->GetHeight() * m_PngThumbnailWidth / img->GetWidth(), 1U);
+      img->Scale(m_PngThumbnailWidth, height);
+    }
+    img->WriteImage(thumbnailName(pngfilename).c_str(), TImage::kPng);
+  }
+  delete img;
+  if (!hashfile.empty())
+  {
+    std::ofstream out(hashfile);
+    out << std::hex << hash << std::endl;
+  }
   return 0;
 }
 
+void OnlMonClient::AddPageTime(const std::string &pngfilename, const std::chrono::steady_clock::time_point &start, const bool unchanged)
+{
+  if (!make_html)
+  {
+    return;
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::string page = std::filesystem::path(pngfilename).filename().string();
+  if (unchanged)
+  {
+    page += " (unchanged)";
+  }
+  m_PageTimes.emplace_back(page, elapsed.count());
+  m_PageFiles.push_back(pngfilename);
+}
+
 int OnlMonClient::SaveLogFile(const OnlMonDraw &drawer)
 {
   // sendfile example shamelessly copied from
@@ -1729,6 +2696,25 @@ OnlMonClient::RunType()
 
 void OnlMonClient::FindAllMonitors()
 {
+  std::vector<OnlMonRegistry::Entry> entries;
+  if (OnlMonRegistry::Read(entries) >= 0)
+  {
+    for (auto &hostiter : MonitorHosts)
+    {
+      for (auto &entry : entries)
+      {
+        if (!OnlMonRegistry::SameHost(hostiter, entry.hostname))
+        {
+          continue;
+        }
+        for (auto &monitor : entry.monitors)
+        {
+          MonitorHostPorts.insert(std::make_pair(monitor, std::make_pair(hostiter, entry.port)));
+        }
+      }
+    }
+    return;
+  }
   for (auto &hostiter : MonitorHosts)
   {
     if (Verbosity() > 2)
@@ -1745,8 +2731,13 @@ void OnlMonClient::FindAllMonitors()
 
 int OnlMonClient::FindMonitor(const std::string &name)
 {
-  // loop over all hosts/ports until we find ours
-  int iret = 0;
+  int iret = LocateInRegistry(name);
+  if (iret >= 0)
+  {
+    return iret;
+  }
+  // not in the registry, loop over all hosts/ports until we find ours
+  iret = 0;
   for (auto &hostiter : MonitorHosts)
   {
     if (Verbosity() > 2)
@@ -1775,27 +2766,112 @@ int OnlMonClient::FindMonitor(const std::string &name)
   return iret;
 }
 
+int OnlMonClient::LocateInRegistry(const std::string &monitor, const std::string &hname)
+{
+  std::vector<OnlMonRegistry::Entry> entries;
+  if (OnlMonRegistry::Read(entries) < 0)
+  {
+    return -1;
+  }
+  // hosts in the same order as the port scan
+  for (auto &hostiter : MonitorHosts)
+  {
+    for (auto &entry : entries)
+    {
+      if (!OnlMonRegistry::SameHost(hostiter, entry.hostname))
+      {
+        continue;
+      }
+      bool found = false;
+      if (hname.empty())
+      {
+        found = (std::find(entry.monitors.begin(), entry.monitors.end(), monitor) != entry.monitors.end());
+      }
+      else
+      {
+        for (auto &histo : entry.histos)
+        {
+          if (histo.second == hname && (monitor.empty() || histo.first == monitor))
+          {
+            found = true;
+            break;
+          }
+        }
+      }
+      if (!found)
+      {
+        continue;
+      }
+      if (Verbosity() > 0)
+      {
+        std::cout << "registry: " << monitor << " " << hname << " on " << hostiter
+                  << " port " << entry.port << std::endl;
+      }
+      // like a HistoList request, everything of this server goes into the maps
+      for (auto &histo : entry.histos)
+      {
+        PutHistoInMap(histo.second, histo.first, hostiter, entry.port);
+      }
+      for (auto &moni : entry.monitors)
+      {
+        MonitorHostPorts[moni] = std::make_pair(hostiter, entry.port);
+        m_MonitorGeneration[moni] = entry.started;
+      }
+      return 1;
+    }
+  }
+  // not listed is not proof of absence: servers which predate the registry, which
+  // started less than a heartbeat ago or failed to write it - the caller scans
+  return -1;
+}
+
 int OnlMonClient::IsMonitorRunning(const std::string &name)
 {
-  int iret = 0;
-  std::string command = std::string("ISRUNNING") + ' ' + name;
+  time_t generation = RequestGeneration(name);
+  if (generation < 0)
+  {
+    return 0;
+  }
+  if (generation > 0)
+  {
+    auto geniter = m_MonitorGeneration.find(name);
+    if (geniter != m_MonitorGeneration.end() && geniter->second != generation)
+    {
+      std::cout << "Server of " << name << " was restarted, updating its histogram locations" << std::endl;
+      RefreshHistoMap(name);
+    }
+    m_MonitorGeneration[name] = generation;
+  }
+  return 1;
+}
+
+time_t OnlMonClient::RequestGeneration(const std::string &name)
+{
+  time_t generation = -1;
   auto moniter = MonitorHostPorts.find(name);
   if (moniter == MonitorHostPorts.end())
   {
-    return iret;
+    return generation;
   }
   TSocket sock(moniter->second.first.c_str(), moniter->second.second);
-  TMessage *mess;
-  sock.Send(command.c_str());
-  sock.Recv(mess);
-  if (!mess)  // if server is not up mess is NULL
-  {
-    std::cout << __PRETTY_FUNCTION__ << "Server not running on " << moniter->second.first << std::endl;
-    sock.Close();
-    return iret;
-  }
-  if (mess->What() == kMESS_STRING)
+  TMessage *mess = nullptr;
+  // servers which do not know GENERATION answer with UnknownHisto, ask them the old way
+  for (const std::string &request : {std::string("GENERATION "), std::string("ISRUNNING ")})
   {
+    sock.Send((request + name).c_str());
+    mess = nullptr;
+    sock.Recv(mess);
+    if (!mess)  // if server is not up mess is NULL
+    {
+      std::cout << __PRETTY_FUNCTION__ << "Server not running on " << moniter->second.first << std::endl;
+      sock.Close();
+      return -1;
+    }
+    if (mess->What() != kMESS_STRING)
+    {
+      delete mess;
+      break;
+    }
     char str[OnlMonDefs::MSGLEN];
     mess->ReadString(str, OnlMonDefs::MSGLEN);
     delete mess;
@@ -1803,14 +2879,78 @@ int OnlMonClient::IsMonitorRunning(const std::string &name)
     {
       std::cout << __PRETTY_FUNCTION__ << "Message: " << str << std::endl;
     }
+    if (!strcmp(str, "UnknownHisto"))
+    {
+      continue;
+    }
     if (!strcmp(str, "Yes"))
     {
-      iret = 1;
+      generation = 0;
+    }
+    else if (strcmp(str, "No"))
+    {
+      generation = std::strtol(str, nullptr, 10);
     }
+    break;
   }
   sock.Send("Finished");
   sock.Close();
-  return iret;
+  return generation;
+}
+
+int OnlMonClient::RefreshHistoMap(const std::string &name)
+{
+  auto moniter = MonitorHostPorts.find(name);
+  if (moniter == MonitorHostPorts.end())
+  {
+    return -1;
+  }
+  // histograms which are gone in the new server have to be located again
+  auto subsysiter = SubsysHisto.find(name);
+  if (subsysiter != SubsysHisto.end())
+  {
+    for (auto &hiter : subsysiter->second)
+    {
+      hiter.second->ServerHost("UNKNOWN");
+      hiter.second->ServerPort(0);
+    }
+  }
+  std::string hostname = moniter->second.first;
+  int moniport = moniter->second.second;
+  TSocket sock(hostname.c_str(), moniport);
+  TMessage *mess = nullptr;
+  sock.Send("HistoList");
+  while (true)
+  {
+    mess = nullptr;
+    sock.Recv(mess);
+    if (!mess)
+    {
+      std::cout << __PRETTY_FUNCTION__ << "Server not running on " << hostname
+                << " port " << moniport << std::endl;
+      sock.Close();
+      return -1;
+    }
+    if (mess->What() != kMESS_STRING)
+    {
+      delete mess;
+      break;
+    }
+    char strchr[OnlMonDefs::MSGLEN];
+    mess->ReadString(strchr, OnlMonDefs::MSGLEN);
+    delete mess;
+    std::string str = strchr;
+    if (str == "Finished")
+    {
+      break;
+    }
+    unsigned int pos_space = str.find(' ');
+    PutHistoInMap(str.substr(pos_space + 1, str.size()), str.substr(0, pos_space), hostname, moniport);
+    sock.Send("Ack");
+  }
+  sock.Send("Finished");
+  sock.Close();
+  return 0;
 }
 
 std::string OnlMonClient::ExtractSubsystem(const std::string &fullfilename, OnlMonDraw *drawer)
@@ -1836,45 +2976,137 @@ OnlMonDraw *OnlMonClient::GetDrawer(const std::string &name)
 
 void OnlMonClient::SaveServerHistoMap(const std::string &cachefilename)
 {
-  std::ofstream cachefile(cachefilename);
   std::cout << "saving histomap to " << cachefilename << std::endl;
+  std::string tmpfilename = cachefilename + ".tmp";
+  std::ofstream cachefile(tmpfilename, std::ios::binary);
+  cachefile.write(HISTOMAPMAGIC, sizeof(HISTOMAPMAGIC));
+  writeValue(cachefile, HISTOMAPVERSION);
+  writeValue(cachefile, static_cast<uint32_t>(SubsysHisto.size()));
   for (auto &subs : SubsysHisto)
   {
+    std::string hostname = "UNKNOWN";
+    int port = 0;
+    auto moniter = MonitorHostPorts.find(subs.first);
+    if (moniter != MonitorHostPorts.end())
+    {
+      hostname = moniter->second.first;
+      port = moniter->second.second;
+    }
+    std::vector<std::string> hnames;
     for (auto &histos : subs.second)
     {
-      cachefile << histos.second->SubSystem() << " " << histos.first << " " << histos.second->ServerHost() << " " << histos.second->ServerPort() << std::endl;
+      if (histos.second->ServerHost() == "UNKNOWN")
+      {
+        continue;  // has to be located anyway
+      }
+      if (hostname == "UNKNOWN")
+      {
+        hostname = histos.second->ServerHost();
+        port = histos.second->ServerPort();
+      }
+      hnames.push_back(histos.first);
+    }
+    auto geniter = m_MonitorGeneration.find(subs.first);
+    writeString(cachefile, subs.first);
+    writeString(cachefile, hostname);
+    writeValue(cachefile, static_cast<int32_t>(port));
+    writeValue(cachefile, static_cast<int64_t>((geniter != m_MonitorGeneration.end()) ? geniter->second : 0));
+    writeValue(cachefile, static_cast<uint32_t>(hnames.size()));
+    for (auto &hname : hnames)
+    {
+      writeString(cachefile, hname);
     }
   }
   cachefile.close();
+  if (cachefile.fail() || rename(tmpfilename.c_str(), cachefilename.c_str()))
+  {
+    std::cout << "failed to write histogram map cache file " << cachefilename << std::endl;
+    remove(tmpfilename.c_str());
+  }
   return;
 }
 
 void OnlMonClient::ReadServerHistoMap(const std::string &cachefilename)
+{
+  std::ifstream cachefile(cachefilename, std::ios::binary);
+  if (!cachefile.good())
+  {
+    std::cout << "failed to open histogram map cache file " << cachefilename << std::endl;
+    return;
+  }
+  char magic[sizeof(HISTOMAPMAGIC)] = {0};
+  uint32_t version = 0;
+  cachefile.read(magic, sizeof(magic));
+  if (!cachefile || memcmp(magic, HISTOMAPMAGIC, sizeof(magic)))
+  {
+    cachefile.close();
+    ReadServerHistoMapText(cachefilename);
+    return;
+  }
+  if (!readValue(cachefile, version) || version != HISTOMAPVERSION)
+  {
+    std::cout << "histogram map cache file " << cachefilename << " has version " << version
+              << ", expected " << HISTOMAPVERSION << ", ignoring it" << std::endl;
+    return;
+  }
+  std::cout << "opened histogram map cache file " << cachefilename << std::endl;
+  uint32_t nmonitors = 0;
+  readValue(cachefile, nmonitors);
+  for (uint32_t imon = 0; imon < nmonitors; imon++)
+  {
+    std::string subsys;
+    std::string hostname;
+    int32_t port = 0;
+    int64_t generation = 0;
+    uint32_t nhistos = 0;
+    if (!readString(cachefile, subsys) || !readString(cachefile, hostname) ||
+        !readValue(cachefile, port) || !readValue(cachefile, generation) || !readValue(cachefile, nhistos))
+    {
+      std::cout << "histogram map cache file " << cachefilename << " is truncated" << std::endl;
+      return;
+    }
+    for (uint32_t ihist = 0; ihist < nhistos; ihist++)
+    {
+      std::string hname;
+      if (!readString(cachefile, hname))
+      {
+        std::cout << "histogram map cache file " << cachefilename << " is truncated" << std::endl;
+        return;
+      }
+      PutHistoInMap(hname, subsys, hostname, port);
+    }
+    if (hostname == "UNKNOWN")
+    {
+      continue;
+    }
+    AddServerHost(hostname);
+    MonitorHostPorts.insert(std::make_pair(subsys, std::make_pair(hostname, port)));
+    if (generation > 0)
+    {
+      m_MonitorGeneration[subsys] = generation;
+    }
+  }
+}
+
+void OnlMonClient::ReadServerHistoMapText(const std::string &cachefilename)
 {
   std::ifstream cachefile(cachefilename);
   std::string hname;
   std::string subsys;
   std::string hostname;
   int port;
-  if (cachefile.good())
-  {
-    std::cout << "opened histogram map cache file " << cachefilename << std::endl;
-    std::string line;
-    while (std::getline(cachefile, line))
-    {
-      std::istringstream iss(line);
-      iss >> subsys;
-      iss >> hname;
-      iss >> hostname;
-      iss >> port;
-      AddServerHost(hostname);
-      PutHistoInMap(hname,subsys,hostname,port);
-      MonitorHostPorts.insert(std::make_pair(subsys, std::make_pair(hostname,port)));
-    }
-    cachefile.close();
-  }
-  else
-  {
-    std::cout << "failed to open histogram map cache file " << cachefilename << std::endl;
+  std::cout << "opened histogram map cache file " << cachefilename << " (text format)" << std::endl;
+  std::string line;
+  while (std::getline(cachefile, line))
+  {
+    std::istringstream iss(line);
+    iss >> subsys;
+    iss >> hname;
+    iss >> hostname;
+    iss >> port;
+    AddServerHost(hostname);
+    PutHistoInMap(hname,subsys,hostname,port);
+    MonitorHostPorts.insert(std::make_pair(subsys, std::make_pair(hostname,port)));
   }
+  cachefile.close();
 }
@@ -4,6 +4,9 @@
 #include <onlmon/OnlMonBase.h>
 #include <onlmon/OnlMonDefs.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <ctime>
 #include <list>
 #include <map>
@@ -15,8 +18,11 @@
 class ClientHistoList;
 class OnlMonDraw;
 class OnlMonHtml;
+class OnlMonShm;
 class TCanvas;
 class TH1;
+class TMessage;
+class TPad;
 class TStyle;
 
 class OnlMonClient : public OnlMonBase
@@ -36,14 +42,44 @@ class OnlMonClient : public OnlMonBase
   int requestHisto(const std::string &what = "ALL", const std::string &hostname = "localhost", const int moniport = OnlMonDefs::MONIPORT);
   int requestHistoList(const std::string &subsys, const std::string &hostname, const int moniport, std::list<std::string> &histolist);
   int requestHistoByName(const std::string &subsystem, const std::string &what = "ALL");
-  int requestHistoBySubSystem(const std::string &subsystem, int getall = 0);
+  // hnames (if given) restricts the request to these histograms
+  int requestHistoBySubSystem(const std::string &subsystem, int getall = 0, const std::set<std::string> *hnames = nullptr);
+  // fetch only what the canvas what of the drawer needs (everything if it did not declare its histograms)
+  int requestHistoForCanvas(const std::string &drawername, const std::string &what = "ALL");
   void registerHisto(const std::string &hname, const std::string &subsys);
+
+  // background fetch for guis (poms): PrepareTransfer() looks up where the
+  // histograms of a drawer live, TransferHistos() only does the network part
+  // (it touches neither the client maps nor ROOT objects, so it can run in a
+  // worker thread) and ReceiveTransfer() streams what was received into the
+  // client cache, like requestHistoList() does
+  struct HistoTransfer
+  {
+    std::string subsys;
+    std::string hostname;
+    int port{0};
+    std::list<std::string> hnames;  // "<subsys> <histo>" as the server expects them
+    std::vector<std::pair<std::string, TMessage *>> received;
+    int status{0};  // 0 ok, -1 server did not answer, -2 timeout
+  };
+  // returns -1 if a server has not been located yet (needs the blocking search)
+  int PrepareTransfer(const std::string &drawername, std::vector<HistoTransfer> &transfers, const std::string &what = "ALL");
+  static int TransferHistos(HistoTransfer &transfer, const int timeout_ms, std::atomic<int> *nreceived = nullptr);
+  int ReceiveTransfer(HistoTransfer &transfer);
+  // requestHistoBySubSystem() answers from the client cache (filled by ReceiveTransfer()) without asking the servers
+  void CacheOnly(const bool b) { m_CacheOnly = b; }
+  // histograms of servers on this node are read from their shared memory
+  // snapshots (see OnlMonShm.h, up to OnlMonShm::MAXAGE seconds old), the rest over the socket
+  void UseSharedMemory(const bool b) { m_UseSharedMemory = b; }
+
   void Print(const char *what = "ALL");
   void PrintHistos(const std::string &what = "ALL");
 
   void AddServerHost(const std::string &hostname);
   void registerDrawer(OnlMonDraw *Drawer);
   int ReadHistogramsFromFile(const std::string &filename, OnlMonDraw *drawer);
+  // reads the files in parallel threads (e.g. all Run_N-TPCMON_k.root of a run)
+  int ReadHistogramsFromFiles(const std::vector<std::string> &filenames, OnlMonDraw *drawer);
   int Draw(const char *who = "ALL", const char *what = "ALL");
   int MakePS(const char *who = "ALL", const char *what = "ALL");
   int MakeHtml(const char *who = "ALL", const char *what = "ALL");
@@ -73,6 +109,11 @@ class OnlMonClient : public OnlMonBase
   int GetDisplaySizeY() { return display_sizey; }
   int CanvasToPng(TCanvas *canvas, std::string const &filename);
   int HistoToPng(TH1 *histo, std::string const &pngfilename, const char *drawopt = "", const int statopt = 11);
+  // width in pixels of the <name>_thumb.png thumbnails written next to each png, 0 (default) for none
+  void SetPngThumbnailWidth(const unsigned int width) { m_PngThumbnailWidth = width; }
+  // html output does not draw a drawer whose histograms did not change and keeps pngs
+  // whose canvas content did not change since they were written (default true)
+  void SetSkipUnchangedPages(const bool b) { m_SkipUnchangedPages = b; }
 
   int SaveLogFile(const OnlMonDraw &drawer);
   int SetStyleToDefault();
@@ -88,14 +129,42 @@ class OnlMonClient : public OnlMonBase
   std::map<std::string, std::tuple<bool, int, int, time_t, int>>::const_iterator GetServerMap(const std::string &subsys) { return m_ServerStatsMap.find(subsys); }
   std::map<std::string, std::tuple<bool, int, int, time_t, int>>::const_iterator GetServerMapEnd() { return m_ServerStatsMap.end(); }
   OnlMonDraw *GetDrawer(const std::string &name);
+  // binary cache of where the histograms live, stamped with the generation
+  // (start time) of each server so a restarted server is recognized on first contact
   void SaveServerHistoMap(const std::string &cachefile = "HistoMap.save");
   void ReadServerHistoMap(const std::string &cachefile = "HistoMap.save");
   bool isHtml() const { return make_html; }
   void isHtml(const bool b) { make_html = b; }
+  // number of worker processes for MakeHtml("ALL") in a batch client without other threads,
+  // 1 runs the drawers one after another
+  void SetHtmlWorkers(const int n) { m_HtmlWorkers = n; }
+  int GetHtmlWorkers() const { return m_HtmlWorkers; }
 
  private:
+  static const unsigned int AGGREGATORRETRY = 60;  // seconds before looking again for an aggregator which was not found
+
   OnlMonClient(const std::string &name = "ONLMONCLIENT");
   int DoSomething(const std::string &who, const std::string &what, const std::string &opt);
+  int MakeHtmlDrawer(OnlMonDraw *drawer, const std::string &what);
+  int MakeHtmlParallel(const std::string &what);
+  int PadToPng(TPad *pad, const std::string &pngfilename);
+  // resolves a monitor (hname empty) or histogram through the registry of running
+  // servers, -1 if the registry is not used or does not list it
+  int LocateInRegistry(const std::string &monitor, const std::string &hname = "");
+  // generation of the server running the monitor: -1 not running, 0 server does not tell
+  time_t RequestGeneration(const std::string &name);
+  // histogram locations of a restarted server, only this monitor is resolved again
+  int RefreshHistoMap(const std::string &name);
+  // HistoMap.save files written before the binary format
+  void ReadServerHistoMapText(const std::string &cachefilename);
+  // reads what it can from the shared memory of the server on port, removes those from hlist
+  int ReadSharedMemory(const std::string &subsys, const int port, std::list<std::string> &hlist);
+  TH1 *ReceiveHisto(TMessage *mess, const std::string &subsys, const std::string &hname);
+  void AddPageTime(const std::string &pngfilename, const std::chrono::steady_clock::time_point &start, const bool unchanged);
+  // skipping a whole drawer in html mode: hash of its histograms before it draws anything,
+  // and whether the pages written from the same hash last time are all there
+  bool HashDrawerInputs(OnlMonDraw *drawer, const std::string &what, uint64_t &hash);
+  bool UnchangedPages(const std::string &inputhashfile, const uint64_t hash, std::vector<std::string> &pages);
   void InitAll();
 
   static OnlMonClient *__instance;
@@ -108,15 +177,25 @@ class OnlMonClient : public OnlMonBase
   int cosmicrun {0};
   int standalone {0};
   int cachedrun {0};
+  int m_HtmlWorkers {1};
+  unsigned int m_PngThumbnailWidth {0};
   bool make_html {false};
+  bool m_CacheOnly {false};
+  bool m_SkipUnchangedPages {true};
+  bool m_UseSharedMemory {false};
   std::string runtype {"unknown_runtype"};
   std::set<std::string> m_MonitorFetchedSet;
   std::map<std::string, std::map<const std::string, ClientHistoList *>> SubsysHisto;
   std::map<std::string, std::pair<std::string, unsigned int>> MonitorHostPorts;
+  std::map<std::string, time_t> m_MonitorGeneration;  // start time of the server of each monitor
+  std::map<std::string, time_t> m_AggregatorMissed;   // aggregators not found and when we looked
+  std::map<int, OnlMonShm *> m_ShmSegments;  // mapped segments of local servers by port
   std::map<const std::string, ClientHistoList *> Histo;
   std::map<const std::string, OnlMonDraw *> DrawerList;
   std::vector<std::string> MonitorHosts;
   std::map<std::string, std::tuple<bool, int, int, time_t, int>> m_ServerStatsMap;
+  std::vector<std::pair<std::string, double>> m_PageTimes;  // png file, seconds to render and write it
+  std::vector<std::string> m_PageFiles;                     // pngs of the drawer being rendered
 };
 
 #endif /* ONLMONCLIENT_ONLMONCLIENT_H */
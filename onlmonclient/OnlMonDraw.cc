@@ -1,5 +1,7 @@
 #include "OnlMonDraw.h"
+#include "OnlMonClient.h"
 
+#include <TH1.h>
 #include <TPad.h>
 #include <TText.h>
 
@@ -10,6 +12,14 @@ OnlMonDraw::OnlMonDraw(const std::string &name)
 {
 }
 
+OnlMonDraw::~OnlMonDraw()
+{
+  for (auto &histo : m_MergedHistos)
+  {
+    delete histo.second;
+  }
+}
+
 int OnlMonDraw::Draw(const std::string & /* what */)
 {
   std::cout << "Draw not implemented by daughter class" << std::endl;
@@ -34,6 +44,84 @@ int OnlMonDraw::MakeHtml(const std::string & /* what */)
   return -1;
 }
 
+void OnlMonDraw::AddCanvasHisto(const std::string &what, const std::string &hname, const std::string &server)
+{
+  m_CanvasHistos[what][server].insert(hname);
+  return;
+}
+
+bool OnlMonDraw::CanvasHistos(const std::string &what, const std::string &server, std::set<std::string> &hnames) const
+{
+  auto canvasiter = m_CanvasHistos.find(what);
+  if (canvasiter == m_CanvasHistos.end())
+  {
+    return false;
+  }
+  for (const auto &serveriter : canvasiter->second)
+  {
+    if (serveriter.first == "ALL" || serveriter.first == server)
+    {
+      hnames.insert(serveriter.second.begin(), serveriter.second.end());
+    }
+  }
+  return true;
+}
+
+void OnlMonDraw::AddMergedCanvasHisto(const std::string &what, const std::string &hname)
+{
+  m_MergedCanvasHistos[what].insert(hname);
+  m_CanvasHistos[what];  // the canvas is declared even if it needs nothing else
+  return;
+}
+
+bool OnlMonDraw::MergedCanvasHistos(const std::string &what, std::set<std::string> &hnames) const
+{
+  for (const auto &canvasiter : m_MergedCanvasHistos)
+  {
+    if (what == "ALL" || canvasiter.first == what)
+    {
+      hnames.insert(canvasiter.second.begin(), canvasiter.second.end());
+    }
+  }
+  return !hnames.empty();
+}
+
+TH1 *OnlMonDraw::getMergedHisto(const std::string &hname)
+{
+  OnlMonClient *cl = OnlMonClient::instance();
+  if (!m_Aggregator.empty())
+  {
+    // the client drops it when the aggregator does not answer
+    TH1 *merged = cl->getHisto(m_Aggregator, hname);
+    if (merged)
+    {
+      return merged;
+    }
+  }
+  TH1 *&sum = m_MergedHistos[hname];
+  bool empty = true;
+  for (const auto &server : m_ServerSet)
+  {
+    TH1 *histo = cl->getHisto(server, hname);
+    if (!histo)
+    {
+      continue;
+    }
+    if (!sum)
+    {
+      sum = static_cast<TH1 *>(histo->Clone());
+      sum->SetDirectory(nullptr);
+    }
+    if (empty)
+    {
+      sum->Reset();
+      empty = false;
+    }
+    sum->Add(histo);
+  }
+  return (empty) ? nullptr : sum;
+}
+
 int OnlMonDraw::DrawDeadServer(TPad *transparentpad)
 {
   transparentpad->cd();
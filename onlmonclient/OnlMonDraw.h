@@ -1,16 +1,18 @@
 #ifndef ONLMONCLIENT_ONLMONDRAW_H
 #define ONLMONCLIENT_ONLMONDRAW_H
 
+#include <map>
 #include <set>
 #include <string>
 
+class TH1;
 class TPad;
 
 class OnlMonDraw
 {
  public:
   OnlMonDraw(const std::string &name = "NONE");
-  virtual ~OnlMonDraw() {}
+  virtual ~OnlMonDraw();
 
   virtual int Init() { return 0; }
   virtual int Draw(const std::string &what = "ALL");
@@ -25,13 +27,30 @@ class OnlMonDraw
   virtual void AddServer(const std::string &server) { m_ServerSet.insert(server); }
   std::set<std::string>::const_iterator ServerBegin() { return m_ServerSet.begin(); }
   std::set<std::string>::const_iterator ServerEnd() { return m_ServerSet.end(); }
+  // histogram hname (from server, "ALL" for every server) is needed by the canvas what (the Draw() argument)
+  void AddCanvasHisto(const std::string &what, const std::string &hname, const std::string &server = "ALL");
+  // histograms of server needed by canvas what, false if the canvas did not declare them
+  bool CanvasHistos(const std::string &what, const std::string &server, std::set<std::string> &hnames) const;
+  // server is an aggregator (OnlMonAggregator) serving the sum of the histograms of our servers
+  void SetAggregator(const std::string &server) { m_Aggregator = server; }
+  const std::string &Aggregator() const { return m_Aggregator; }
+  // canvas what draws the sum of hname over all servers, it is read from the aggregator while that one runs
+  void AddMergedCanvasHisto(const std::string &what, const std::string &hname);
+  // summed histograms needed by canvas what ("ALL": by any canvas)
+  bool MergedCanvasHistos(const std::string &what, std::set<std::string> &hnames) const;
 
  protected:
   virtual int DrawDeadServer(TPad *transparent);
+  // sum of hname over all servers, from the aggregator or added up here if it is not running
+  TH1 *getMergedHisto(const std::string &hname);
   int verbosity{0};
   bool make_html{false};
   std::string ThisName;
   std::set<std::string> m_ServerSet;
+  std::map<std::string, std::map<std::string, std::set<std::string>>> m_CanvasHistos;  // canvas -> server -> histos
+  std::string m_Aggregator;
+  std::map<std::string, std::set<std::string>> m_MergedCanvasHistos;  // canvas -> summed histos
+  std::map<std::string, TH1 *> m_MergedHistos;                        // sums added up by us
 };
 
 #endif /* ONLMONCLIENT_ONLMONDRAW_H */
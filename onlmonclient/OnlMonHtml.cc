@@ -3,14 +3,20 @@
 #include <onlmon/RunDBodbc.h>
 
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cerrno>
 #include <cstddef>  // for size_t
+#include <cstdio>   // for rename, remove
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <set>
 #include <sstream>
 #include <vector>
@@ -69,6 +75,37 @@ namespace
     }
     return rv;
   }
+
+  //___________________________________________________________________________
+  // exclusive lock on the menu of a run directory, html generators running
+  // in parallel (several subsystems or forked drawers) read-modify-write
+  // the same menu files
+  class MenuLock
+  {
+   public:
+    explicit MenuLock(const std::string& lockfile)
+      : fd(open(lockfile.c_str(), O_RDWR | O_CREAT, 0664))
+    {
+      if (fd >= 0)
+      {
+        flock(fd, LOCK_EX);
+      }
+    }
+    ~MenuLock()
+    {
+      if (fd >= 0)
+      {
+        flock(fd, LOCK_UN);
+        close(fd);
+      }
+    }
+    // delete copy ctor and assignment operator (cppcheck)
+    explicit MenuLock(const MenuLock&) = delete;
+    MenuLock& operator=(const MenuLock&) = delete;
+
+   private:
+    int fd{-1};
+  };
 }  // namespace
 
 //_____________________________________________________________________________
@@ -91,60 +128,59 @@ OnlMonHtml::~OnlMonHtml()
 }
 
 //_____________________________________________________________________________
-void OnlMonHtml::addMenu(const std::string& header, const std::string& path,
-                         const std::string& relfilename)
+void OnlMonHtml::beginMenu()
 {
-  std::ostringstream menufile;
+  fMenuTransaction = true;
+}
 
-  menufile << fHtmlRunDir << "/menu";
+//_____________________________________________________________________________
+void OnlMonHtml::endMenu()
+{
+  fMenuTransaction = false;
+  if (fMenuEntries.empty())
+  {
+    return;
+  }
 
-  std::ifstream in(menufile.str().c_str());
+  std::string menufile = fHtmlRunDir + "/menu";
 
-  if (!in.good())
+  // other html generators (subsystems, forked drawers) may update the same
+  // menu in the meantime, so merge with what is on disk under the lock
+  MenuLock lock(menufile + ".lock");
+
+  std::set<std::string> olines;
+  std::ifstream in(menufile);
+  bool menuexists = in.good();
+  if (menuexists)
   {
     if (verbosity())
     {
-      std::cout << __PRETTY_FUNCTION__ << "File " << menufile.str() << " does not exist."
-                << "I'm creating it now" << std::endl;
+      std::cout << __PRETTY_FUNCTION__ << "Reading file " << menufile << std::endl;
     }
-    std::ofstream out(menufile.str().c_str());
-    out.close();
-  }
-  else
-  {
-    if (verbosity())
+    std::string line;
+    while (std::getline(in, line))
     {
-      std::cout << __PRETTY_FUNCTION__ << "Reading file " << menufile.str() << std::endl;
+      olines.insert(line);
     }
   }
-
-  // we read back the old menu file...
-  std::vector<std::string> lines;
-  char str[1024];
-  while (in.getline(str, 1024, '\n'))
+  else if (verbosity())
   {
-    lines.emplace_back(str);
+    std::cout << __PRETTY_FUNCTION__ << "File " << menufile << " does not exist."
+              << "I'm creating it now" << std::endl;
   }
   in.close();
 
-  // ... we then append the requested new entry...
-  std::ostringstream sline;
-  sline << header << "/" << path << "/" << relfilename;
-
-  lines.push_back(sline.str());
-
-  // ... and we sort this out...
-  sort(lines.begin(), lines.end());
-
-  // ... and we remove duplicates lines...
-  std::set<std::string> olines;
-  copy(lines.begin(), lines.end(),
-       std::insert_iterator<std::set<std::string> >(olines, olines.begin()));
+  size_t oldsize = olines.size();
+  olines.insert(fMenuEntries.begin(), fMenuEntries.end());
+  fMenuEntries.clear();
+  if (olines.size() == oldsize && menuexists)
+  {
+    return;  // nothing new, menu and menu.html are up to date
+  }
 
-  // ... and finally we write the full new menu file out.
-  std::ofstream out(menufile.str());
+  std::ostringstream out;
   copy(olines.begin(), olines.end(), std::ostream_iterator<std::string>(out, "\n"));
-  out.close();
+  writeAtomic(menufile, out.str());
 
   // --end of normal menu generation--
 
@@ -156,25 +192,34 @@ void OnlMonHtml::addMenu(const std::string& header, const std::string& path,
 }
 
 //_____________________________________________________________________________
-void OnlMonHtml::plainHtmlMenu(const std::set<std::string>& olines)
+void OnlMonHtml::addMenu(const std::string& header, const std::string& path,
+                         const std::string& relfilename)
 {
-  std::ostringstream htmlmenufile;
-
-  htmlmenufile << fHtmlRunDir << "/menu.html";
+  fMenuEntries.insert(header + "/" + path + "/" + relfilename);
+  if (!fMenuTransaction)
+  {
+    endMenu();
+  }
+}
 
-  // First get the list of directories found in menu file above (contained
-  // in olines set). The olines are of the form:
-  // D1/D2/TITLE/link (where link is generally somefile.gif)
-  // The dir in this case is D1/D2, which is why we look for 2 slashes
-  // below (the one before TITLE and the one before link).
+//_____________________________________________________________________________
+void OnlMonHtml::plainHtmlMenu(const std::set<std::string>& olines)
+{
+  std::string htmlmenufile = fHtmlRunDir + "/menu.html";
+
+  // The olines are of the form D1/D2/TITLE/link (where link is generally
+  // somefile.png). The dir in this case is D1/D2, which is why we look for
+  // 2 slashes below (the one before TITLE and the one before link).
+  // Group the TITLE/link entries by their dir in one pass, and collect the
+  // list of all directories (D1 and D1/D2 in this example).
+  std::map<std::string, std::vector<std::string> > entries;
   std::set<std::string> dirlist;
-  std::set<std::string>::const_iterator it;
-  for (it = olines.begin(); it != olines.end(); ++it)
+  for (const auto& line : olines)
   {
-    const std::string& line = *it;
     std::string::size_type pos = line.find_last_of('/');
     pos = line.substr(0, pos).find_last_of('/');
     std::string dir = line.substr(0, pos);
+    entries[dir].push_back(line.substr(dir.size() + 1));
     std::vector<std::string> parts = split('/', dir);
     for (size_t i = 0; i <= parts.size(); ++i)
     {
@@ -185,18 +230,10 @@ void OnlMonHtml::plainHtmlMenu(const std::set<std::string>& olines)
   }
 
   // We now generate the menu.html file.
-  std::ofstream out(htmlmenufile.str().c_str());
-  if (!out.good())
-  {
-    std::cout << __PRETTY_FUNCTION__ << " cannot open output file "
-              << htmlmenufile.str() << std::endl;
-    return;
-  }
-
-  for (it = dirlist.begin(); it != dirlist.end(); ++it)
+  std::ostringstream out;
+  for (const auto& dir : dirlist)
   {
     // in the example above, dir is D1/D2
-    const std::string& dir = *it;
     int nslashes = count(dir.begin(), dir.end(), '/') + 1;
     std::string name = dir;
     std::string::size_type pos = dir.find_last_of('/');
@@ -211,31 +248,48 @@ void OnlMonHtml::plainHtmlMenu(const std::set<std::string>& olines)
     out << "<H" << nslashes << ">" << name
         << "</H" << nslashes << "><BR>\n";
 
-    // We then loop on all the olines, and for those matching the
-    // dir pattern, we generate link <A HREF="link">TITLE</A>
-    std::set<std::string>::const_iterator it2;
-    for (it2 = olines.begin(); it2 != olines.end(); ++it2)
+    // for all the TITLE/link entries of this dir we generate
+    // <A HREF="link">TITLE</A>
+    auto dirEntries = entries.find(dir);
+    if (dirEntries == entries.end())
+    {
+      continue;
+    }
+    for (const auto& sline : dirEntries->second)
     {
-      const std::string& line = *it2;
-      std::string::size_type pos2 = line.find_last_of('/');
-      pos2 = line.substr(0, pos2).find_last_of('/');
-      std::string ldir = line.substr(0, pos2);
-      if (ldir == dir)  // we get a matching line
+      std::string::size_type pos2 = sline.find('/');
+      if (pos2 < sline.size())
       {
-        std::string sline = line.substr(dir.size() + 1);
-        // in the example above, sline is TITLE/link...
-        pos2 = sline.find('/');
-        // ...which we split at the slash pos
-        if (pos2 < sline.size())
-        {
-          out << "<A HREF=\""
-              << sline.substr(pos + 1) << "\">"
-              << sline.substr(0, pos) << "</A><BR>\n";
-        }
+        out << "<A HREF=\""
+            << sline.substr(pos2 + 1) << "\">"
+            << sline.substr(0, pos2) << "</A><BR>\n";
       }
     }
   }
+  writeAtomic(htmlmenufile, out.str());
+}
+
+//_____________________________________________________________________________
+// write to a temporary file in the same directory and rename it, so
+// readers (the web server) never see a half written file
+void OnlMonHtml::writeAtomic(const std::string& filename, const std::string& content)
+{
+  std::string tmpname = filename + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmpname);
+  if (!out.good())
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot open output file "
+              << tmpname << std::endl;
+    return;
+  }
+  out << content;
   out.close();
+  if (!out || std::rename(tmpname.c_str(), filename.c_str()))
+  {
+    std::cout << __PRETTY_FUNCTION__ << " could not write " << filename
+              << ": " << std::strerror(errno) << std::endl;
+    std::remove(tmpname.c_str());
+  }
 }
 
 //_____________________________________________________________________________
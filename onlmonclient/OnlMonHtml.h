@@ -21,6 +21,8 @@ class OnlMonHtml
   virtual ~OnlMonHtml();
 
   /** Generate a bit of the navigation menu for a given file (link).
+   *  Between beginMenu() and endMenu() the entry is only kept in memory,
+   *  otherwise the menu files are updated right away.
    *  @param path the path as it will appear in the menu
    *  @param relfilename the filename that will be served when using
    *  path in the menu (must not be a fullpathname, but a plain filename).
@@ -28,6 +30,13 @@ class OnlMonHtml
   void addMenu(const std::string& header, const std::string& path,
                const std::string& relfilename);
 
+  /** Collect the menu entries of a whole MakeHtml pass in memory and
+   *  write menu and menu.html only once in endMenu() (merged with the
+   *  existing menu, atomically via rename).
+   */
+  void beginMenu();
+  void endMenu();
+
   /** Generate filenames, to be used to produce e.g. gif or html files.
    *  @param drawer the OnlMonDraw child class for which filename must be built
    *  @param basefilename the beginning of the filename
@@ -63,6 +72,7 @@ class OnlMonHtml
 
  protected:
   void plainHtmlMenu(const std::set<std::string>&);
+  void writeAtomic(const std::string& filename, const std::string& content);
   void runInit();
   std::string runRange();
   void set_group_sticky_bit(const std::filesystem::path& dir);
@@ -71,9 +81,11 @@ class OnlMonHtml
 
   int fVerbosity = 0;
   int fRunNumber = 0;
+  bool fMenuTransaction = false;
 
   std::string fHtmlDir;
   std::string fHtmlRunDir;
+  std::set<std::string> fMenuEntries;  // added since the last endMenu()
 };
 
 #endif
@@ -0,0 +1,462 @@
+#include "OnlMonAggregator.h"
+#include "HistoBinDefs.h"
+#include "OnlMonDefs.h"
+#include "OnlMonRegistry.h"
+#include "OnlMonServer.h"
+
+#include <MessageTypes.h>  // for kMESS_OBJECT, kMESS_STRING
+#include <TH1.h>
+#include <TMessage.h>
+#include <TSocket.h>
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+  // FNV-1a, only used to recognize histograms which did not change
+  uint64_t hashBytes(const char *data, const int len)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < len; i++)
+    {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+}  // namespace
+
+OnlMonAggregator::OnlMonAggregator(const std::string &name)
+  : OnlMon(name)
+{
+  return;
+}
+
+OnlMonAggregator::~OnlMonAggregator()
+{
+  // the merged histograms are owned by the server
+  for (auto &srciter : m_Sources)
+  {
+    for (auto &cacheiter : srciter.second.histos)
+    {
+      delete cacheiter.second.histo;
+    }
+  }
+  return;
+}
+
+int OnlMonAggregator::Reset()
+{
+  for (auto &histiter : m_Merged)
+  {
+    histiter.second->Reset();
+  }
+  m_Contributors.clear();  // rebuild all sums in the next Update()
+  return 0;
+}
+
+void OnlMonAggregator::AddServerHost(const std::string &hostname)
+{
+  if (std::find(m_ServerHosts.begin(), m_ServerHosts.end(), hostname) == m_ServerHosts.end())
+  {
+    m_ServerHosts.push_back(hostname);
+  }
+  return;
+}
+
+void OnlMonAggregator::AddSource(const std::string &monitorname)
+{
+  if (monitorname == Name())
+  {
+    std::cout << __PRETTY_FUNCTION__ << " " << Name() << " cannot merge itself" << std::endl;
+    return;
+  }
+  m_Sources.insert(std::make_pair(monitorname, Source()));
+  return;
+}
+
+void OnlMonAggregator::AddSources(const std::string &basename, const unsigned int nservers)
+{
+  for (unsigned int i = 0; i < nservers; i++)
+  {
+    AddSource(basename + '_' + std::to_string(i));
+  }
+  return;
+}
+
+int OnlMonAggregator::FindSources()
+{
+  int nfound = 0;
+  std::vector<OnlMonRegistry::Entry> entries;
+  if (OnlMonRegistry::Read(entries) >= 0)
+  {
+    for (auto &hostname : m_ServerHosts)
+    {
+      for (auto &entry : entries)
+      {
+        if (!OnlMonRegistry::SameHost(hostname, entry.hostname))
+        {
+          continue;
+        }
+        for (auto &monitorname : entry.monitors)
+        {
+          auto srciter = m_Sources.find(monitorname);
+          if (srciter != m_Sources.end() && srciter->second.port < 0)
+          {
+            srciter->second.hostname = hostname;
+            srciter->second.port = entry.port;
+            nfound++;
+          }
+        }
+      }
+    }
+    // not listed is not proof of absence (see OnlMonClient::FindMonitor), scan for the rest
+    bool missing = false;
+    for (auto &srciter : m_Sources)
+    {
+      if (srciter.second.port < 0)
+      {
+        missing = true;
+        break;
+      }
+    }
+    if (!missing)
+    {
+      return nfound;
+    }
+  }
+  for (auto &hostname : m_ServerHosts)
+  {
+    for (unsigned int moniport = OnlMonDefs::MONIPORT; moniport < OnlMonDefs::MONIPORT + OnlMonDefs::NUMMONIPORT; ++moniport)
+    {
+      TSocket sock(hostname.c_str(), moniport);
+      if (!sock.IsValid())
+      {
+        continue;
+      }
+      TMessage *mess = nullptr;
+      sock.Send("LISTMONITORS");
+      sock.Recv(mess);  // "go"
+      if (!mess)
+      {
+        sock.Close();
+        continue;
+      }
+      delete mess;
+      while (true)
+      {
+        mess = nullptr;
+        sock.Recv(mess);
+        if (!mess || mess->What() != kMESS_STRING)
+        {
+          delete mess;
+          break;
+        }
+        char strmess[OnlMonDefs::MSGLEN];
+        mess->ReadString(strmess, OnlMonDefs::MSGLEN);
+        delete mess;
+        std::string str(strmess);
+        if (str == "Finished")
+        {
+          break;
+        }
+        auto srciter = m_Sources.find(str);
+        if (srciter != m_Sources.end() && srciter->second.port < 0)
+        {
+          if (Verbosity() > 0)
+          {
+            std::cout << Name() << ": found " << str << " on " << hostname
+                      << " port " << moniport << std::endl;
+          }
+          srciter->second.hostname = hostname;
+          srciter->second.port = moniport;
+          nfound++;
+        }
+      }
+      sock.Send("Finished");
+      sock.Close();
+    }
+  }
+  return nfound;
+}
+
+int OnlMonAggregator::RequestHistoList(TSocket &sock, const std::string &monitorname, Source &src)
+{
+  TMessage *mess = nullptr;
+  sock.Send("HistoList");
+  while (true)
+  {
+    sock.Recv(mess);
+    if (!mess)
+    {
+      return -1;
+    }
+    if (mess->What() != kMESS_STRING)
+    {
+      delete mess;
+      return -1;
+    }
+    char strmess[OnlMonDefs::MSGLEN];
+    mess->ReadString(strmess, OnlMonDefs::MSGLEN);
+    delete mess;
+    mess = nullptr;
+    std::string str(strmess);
+    if (str == "Finished")
+    {
+      break;
+    }
+    // "<monitor> <histo>" for all monitors of this server
+    unsigned int pos_space = str.find(' ');
+    if (str.substr(0, pos_space) == monitorname)
+    {
+      src.histonames.push_back(str.substr(pos_space + 1, str.size()));
+    }
+    sock.Send("Ack");
+  }
+  return 0;
+}
+
+void OnlMonAggregator::DropSource(Source &src)
+{
+  // its last histograms must not stay in the sums
+  for (auto &cacheiter : src.histos)
+  {
+    delete cacheiter.second.histo;
+  }
+  src.histos.clear();
+  src.histonames.clear();
+  src.runnumber = -1;
+  src.port = -1;
+  return;
+}
+
+int OnlMonAggregator::FetchSource(const std::string &monitorname, Source &src, std::set<std::string> &changed)
+{
+  TSocket sock(src.hostname.c_str(), src.port);
+  if (!sock.IsValid())
+  {
+    DropSource(src);  // look for it again, it might have been restarted somewhere else
+    return -1;
+  }
+  if (src.histonames.empty() && RequestHistoList(sock, monitorname, src))
+  {
+    sock.Close();
+    DropSource(src);
+    return -1;
+  }
+  TMessage *mess = nullptr;
+  sock.Send("LIST");
+  sock.Recv(mess);  // "go"
+  if (!mess)
+  {
+    sock.Close();
+    DropSource(src);
+    return -1;
+  }
+  delete mess;
+  for (auto &hname : src.histonames)
+  {
+    std::string what = monitorname + ' ' + hname;
+    sock.Send(what.c_str());
+    mess = nullptr;
+    sock.Recv(mess);
+    if (!mess)
+    {
+      std::cout << __PRETTY_FUNCTION__ << " lost connection to " << monitorname << std::endl;
+      sock.Close();
+      DropSource(src);
+      return -1;
+    }
+    if (mess->What() == kMESS_OBJECT)
+    {
+      // identical bytes - identical histogram, skip reading it
+      uint64_t hash = hashBytes(mess->Buffer(), mess->BufferSize());
+      CachedHisto &cached = src.histos[hname];
+      if (!cached.histo || cached.hash != hash)
+      {
+        TH1 *histo = static_cast<TH1 *>(mess->ReadObjectAny(mess->GetClass()));
+        if (histo)
+        {
+          histo->SetDirectory(nullptr);
+          delete cached.histo;
+          cached.histo = histo;
+          cached.hash = hash;
+          changed.insert(hname);
+        }
+      }
+    }
+    // "UnknownHisto" - not (yet) registered in this instance
+    delete mess;
+  }
+  sock.Send("alldone");
+  mess = nullptr;
+  sock.Recv(mess);  // "Finished"
+  delete mess;
+  sock.Send("Finished");
+  sock.Close();
+
+  auto fwviter = src.histos.find("FrameWorkVars");
+  if (fwviter != src.histos.end() && fwviter->second.histo)
+  {
+    src.runnumber = fwviter->second.histo->GetBinContent(RUNNUMBERBIN);
+  }
+  return 0;
+}
+
+int OnlMonAggregator::Update()
+{
+  for (auto &srciter : m_Sources)
+  {
+    if (srciter.second.port < 0)
+    {
+      FindSources();
+      break;
+    }
+  }
+  int nanswered = 0;
+  std::set<std::string> changed;
+  for (auto &srciter : m_Sources)
+  {
+    if (srciter.second.port < 0)
+    {
+      continue;
+    }
+    if (FetchSource(srciter.first, srciter.second, changed) == 0)
+    {
+      nanswered++;
+    }
+  }
+  // instances still in the previous run would spoil the sums
+  int newestrun = -1;
+  for (auto &srciter : m_Sources)
+  {
+    newestrun = std::max(newestrun, srciter.second.runnumber);
+  }
+  std::set<std::string> contributors;
+  for (auto &srciter : m_Sources)
+  {
+    if (!srciter.second.histos.empty() && srciter.second.runnumber == newestrun)
+    {
+      contributors.insert(srciter.first);
+    }
+  }
+  std::set<std::string> rebuild;
+  if (contributors != m_Contributors)
+  {
+    for (auto &monitorname : contributors)
+    {
+      rebuild.insert(m_Sources[monitorname].histonames.begin(), m_Sources[monitorname].histonames.end());
+    }
+    // sums of histograms only the dropped instances had go back to zero
+    for (auto &histiter : m_Merged)
+    {
+      rebuild.insert(histiter.first);
+    }
+  }
+  else
+  {
+    rebuild = changed;
+  }
+
+  // the server thread sends the merged histograms out
+  OnlMonServer *se = OnlMonServer::instance();
+  se->LockHistos();
+  for (auto &hname : rebuild)
+  {
+    if (hname == "FrameWorkVars" || m_SkipHistos.find(hname) != m_SkipHistos.end())
+    {
+      continue;
+    }
+    MergeHisto(hname, contributors);
+  }
+  if (!rebuild.empty())
+  {
+    MergeFrameWorkVars(contributors);
+  }
+  m_Contributors = contributors;
+  se->PublishSharedMemory();
+  se->UnlockHistos();
+  if (Verbosity() > 0)
+  {
+    std::cout << Name() << ": " << nanswered << " of " << m_Sources.size() << " instances answered, "
+              << contributors.size() << " in run " << newestrun << ", "
+              << rebuild.size() << " histograms merged" << std::endl;
+  }
+  return nanswered;
+}
+
+void OnlMonAggregator::MergeHisto(const std::string &hname, const std::set<std::string> &contributors)
+{
+  TH1 *merged = nullptr;
+  auto histiter = m_Merged.find(hname);
+  if (histiter != m_Merged.end())
+  {
+    merged = histiter->second;
+    merged->Reset();
+  }
+  for (auto &monitorname : contributors)
+  {
+    auto cacheiter = m_Sources[monitorname].histos.find(hname);
+    if (cacheiter == m_Sources[monitorname].histos.end() || !cacheiter->second.histo)
+    {
+      continue;
+    }
+    if (!merged)
+    {
+      // first time we see this one, the sum keeps its binning and name
+      merged = static_cast<TH1 *>(cacheiter->second.histo->Clone());
+      merged->SetDirectory(nullptr);
+      m_Merged[hname] = merged;
+      OnlMonServer::instance()->registerHisto(this, merged);
+      continue;
+    }
+    merged->Add(cacheiter->second.histo);
+  }
+  return;
+}
+
+void OnlMonAggregator::MergeFrameWorkVars(const std::set<std::string> &contributors)
+{
+  TH1 *frameworkvars = OnlMonServer::instance()->getCommonHisto("FrameWorkVars");
+  if (!frameworkvars)
+  {
+    return;
+  }
+  for (int ibin = 1; ibin <= NFRAMEWORKBINS; ibin++)
+  {
+    double value = 0;
+    bool first = true;
+    for (auto &monitorname : contributors)
+    {
+      auto cacheiter = m_Sources[monitorname].histos.find("FrameWorkVars");
+      if (cacheiter == m_Sources[monitorname].histos.end() || !cacheiter->second.histo)
+      {
+        continue;
+      }
+      double content = cacheiter->second.histo->GetBinContent(ibin);
+      switch (ibin)
+      {
+      case RUNNUMBERBIN:
+      case CURRENTTIMEBIN:
+      case EORTIMEBIN:
+        value = (first) ? content : std::max(value, content);
+        break;
+      case BORTIMEBIN:
+      case EARLYEVENTTIMEBIN:
+        if (content > 0)
+        {
+          value = (value > 0) ? std::min(value, content) : content;
+        }
+        break;
+      default:  // event counters
+        value += content;
+        break;
+      }
+      first = false;
+    }
+    frameworkvars->SetBinContent(ibin, value);
+  }
+  return;
+}
@@ -0,0 +1,96 @@
+#ifndef ONLMONSERVER_ONLMONAGGREGATOR_H
+#define ONLMONSERVER_ONLMONAGGREGATOR_H
+
+/**
+Virtual monitor which merges the histograms of all instances of a
+multi-server subsystem (TPCMON_0 ... TPCMON_23, MVTXMON_0 ... MVTXMON_5)
+and serves the sums under its own name, e.g. "TPCMON". It runs in its own
+server process (no event loop, see start_aggregator() in ServerFuncs.C)
+and talks to the instances with the normal server protocol, so the
+clients ask one server for one merged histogram instead of transferring
+and adding 24 copies each.
+
+Update() fetches the histograms of every instance. Copies which did not
+change since the last update (same bytes on the wire) are neither
+deserialized nor merged again, only the sums with at least one changed
+input are rebuilt. Only instances which are in the newest run contribute.
+FrameWorkVars is combined (latest times, summed counters), not added.
+
+\begin{verbatim}
+  OnlMonAggregator *agg = new OnlMonAggregator("TPCMON");
+  agg->AddServerHost("ebdc00");
+  agg->AddSources("TPCMON", 24);  // TPCMON_0 ... TPCMON_23
+  OnlMonServer::instance()->registerMonitor(agg);
+  start_aggregator(agg);
+\end{verbatim}
+*/
+
+#include "OnlMon.h"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class Event;
+class TH1;
+class TSocket;
+
+class OnlMonAggregator : public OnlMon
+{
+ public:
+  explicit OnlMonAggregator(const std::string &name);
+  ~OnlMonAggregator() override;
+
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit OnlMonAggregator(const OnlMonAggregator &) = delete;
+  OnlMonAggregator &operator=(const OnlMonAggregator &) = delete;
+
+  int process_event(Event * /* evt */) override { return 0; }
+  int Reset() override;
+
+  // hosts which are searched for the instances
+  void AddServerHost(const std::string &hostname);
+  // instance to be merged, e.g. TPCMON_3
+  void AddSource(const std::string &monitorname);
+  // instances basename_0 ... basename_<nservers-1>
+  void AddSources(const std::string &basename, const unsigned int nservers);
+  // histograms which are not added up (e.g. per server ring buffers)
+  void SkipHisto(const std::string &hname) { m_SkipHistos.insert(hname); }
+
+  // fetch the instances and rebuild the changed sums, returns the number of instances which answered
+  int Update();
+
+ private:
+  struct CachedHisto
+  {
+    TH1 *histo{nullptr};
+    uint64_t hash{0};
+  };
+
+  struct Source
+  {
+    std::string hostname;
+    int port{-1};
+    int runnumber{-1};
+    std::vector<std::string> histonames;
+    std::map<std::string, CachedHisto> histos;
+  };
+
+  int FindSources();
+  // forget the cached histograms of an instance which does not answer
+  void DropSource(Source &src);
+  int FetchSource(const std::string &monitorname, Source &src, std::set<std::string> &changed);
+  int RequestHistoList(TSocket &sock, const std::string &monitorname, Source &src);
+  void MergeHisto(const std::string &hname, const std::set<std::string> &contributors);
+  void MergeFrameWorkVars(const std::set<std::string> &contributors);
+
+  std::vector<std::string> m_ServerHosts;
+  std::map<std::string, Source> m_Sources;
+  std::map<std::string, TH1 *> m_Merged;
+  std::set<std::string> m_SkipHistos;
+  std::set<std::string> m_Contributors;  // instances which went into the current sums
+};
+
+#endif /* ONLMONSERVER_ONLMONAGGREGATOR_H */
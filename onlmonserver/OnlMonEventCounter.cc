@@ -0,0 +1,141 @@
+#include "OnlMonEventCounter.h"
+
+#include <TH1.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  // first event of the block of width events which contains event
+  int BlockStart(const int event, const int width)
+  {
+    return event - event % width;
+  }
+}  // namespace
+
+TH1 *OnlMonEventCounter::Book(const char *name, const char *title, const int npairs)
+{
+  int nbins = 2 * std::clamp(npairs, 2, MAXPAIRS);
+  TH1 *h = new TH1I(name, title, nbins, -0.5, nbins - 0.5);
+  h->SetBinContent(nbins + 1, 1);  // block width
+  return h;
+}
+
+void OnlMonEventCounter::Fill(TH1 *h, const int event, const double count)
+{
+  int npairs = Pairs(h);
+  int nbins = h->GetNbinsX();
+  if (npairs > 0 && 2 * npairs + 2 > nbins && h->GetBinContent(2 * npairs - 1) != BlockStart(event, BlockWidth(h)))
+  {
+    if (nbins < 2 * MAXPAIRS)
+    {
+      // SetBins() drops the contents, keep the used bins and double the size
+      int width = BlockWidth(h);
+      std::vector<double> content(2 * npairs);
+      for (int ib = 0; ib < 2 * npairs; ib++)
+      {
+        content[ib] = h->GetBinContent(ib + 1);
+      }
+      nbins = std::min(2 * nbins, 2 * MAXPAIRS);
+      h->SetBins(nbins, -0.5, nbins - 0.5);
+      for (int ib = 0; ib < 2 * npairs; ib++)
+      {
+        h->SetBinContent(ib + 1, content[ib]);
+      }
+      h->SetBinContent(nbins + 1, width);
+    }
+    else
+    {
+      Coarsen(h);
+      npairs = Pairs(h);
+    }
+  }
+  int block = BlockStart(event, BlockWidth(h));
+  // still full: only possible with absurd event numbers, the last block takes it
+  if (npairs > 0 && (h->GetBinContent(2 * npairs - 1) == block || 2 * npairs + 2 > nbins))
+  {
+    h->SetBinContent(2 * npairs, h->GetBinContent(2 * npairs) + count);
+    return;
+  }
+  h->SetBinContent(2 * npairs + 1, block);
+  h->SetBinContent(2 * npairs + 2, count);
+  h->SetBinContent(0, npairs + 1);
+  return;
+}
+
+void OnlMonEventCounter::Coarsen(TH1 *h)
+{
+  int npairs = Pairs(h);
+  int width = BlockWidth(h);
+  int capacity = h->GetNbinsX() / 2;
+  while (npairs > capacity / 2 && width < (1 << 30))
+  {
+    width *= 2;
+    // ascending events stay ascending, merged pairs are neighbours
+    int nmerged = 0;
+    for (int i = 0; i < npairs; i++)
+    {
+      int block = BlockStart(static_cast<int>(h->GetBinContent(2 * i + 1)), width);
+      double count = h->GetBinContent(2 * i + 2);
+      if (nmerged > 0 && h->GetBinContent(2 * nmerged - 1) == block)
+      {
+        h->SetBinContent(2 * nmerged, h->GetBinContent(2 * nmerged) + count);
+        continue;
+      }
+      h->SetBinContent(2 * nmerged + 1, block);
+      h->SetBinContent(2 * nmerged + 2, count);
+      nmerged++;
+    }
+    for (int ib = 2 * nmerged + 1; ib <= 2 * npairs; ib++)
+    {
+      h->SetBinContent(ib, 0);
+    }
+    npairs = nmerged;
+  }
+  h->SetBinContent(0, npairs);
+  h->SetBinContent(h->GetNbinsX() + 1, width);
+  return;
+}
+
+void OnlMonEventCounter::Render(const TH1 *h, TH1 *dense)
+{
+  dense->Reset();
+  if (!h)
+  {
+    return;
+  }
+  int npairs = Pairs(h);
+  double center = 0.5 * (BlockWidth(h) - 1);  // counts of a block go to its middle
+  for (int i = 0; i < npairs; i++)
+  {
+    dense->Fill(h->GetBinContent(2 * i + 1) + center, h->GetBinContent(2 * i + 2));
+  }
+  return;
+}
+
+int OnlMonEventCounter::Pairs(const TH1 *h)
+{
+  int npairs = static_cast<int>(h->GetBinContent(0));
+  if (npairs < 0 || 2 * npairs > h->GetNbinsX())
+  {
+    return 0;
+  }
+  return npairs;
+}
+
+int OnlMonEventCounter::LastEvent(const TH1 *h)
+{
+  int npairs = Pairs(h);
+  if (npairs == 0)
+  {
+    return -1;
+  }
+  return static_cast<int>(h->GetBinContent(2 * npairs - 1)) + BlockWidth(h) - 1;
+}
+
+int OnlMonEventCounter::BlockWidth(const TH1 *h)
+{
+  int width = static_cast<int>(h->GetBinContent(h->GetNbinsX() + 1));
+  return (width > 1) ? width : 1;
+}
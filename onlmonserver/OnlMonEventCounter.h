@@ -0,0 +1,43 @@
+#ifndef ONLMONSERVER_ONLMONEVENTCOUNTER_H
+#define ONLMONSERVER_ONLMONEVENTCOUNTER_H
+
+class TH1;
+
+// Sparse "count vs event number" plots. Instead of booking one bin per
+// event (most of them stay empty and all of them go over the wire) the
+// server keeps a sorted list of (event number, count) pairs in a TH1I:
+// bin 2i+1 holds the event number, bin 2i+2 its count and the underflow
+// bin the number of pairs in use. Events have to come in ascending order
+// (the event counter of the monitor), so a Fill() is O(1). The histogram
+// doubles its number of bins when it is full, up to MAXPAIRS pairs. Then
+// the pairs are merged into blocks of events (width in the overflow bin)
+// twice as wide until half of them are free, so long runs lose resolution
+// instead of memory; there is no upper limit on the event number. Such a
+// histogram is registered and saved like any other one, the client has to
+// Render() it into a normal histogram with the range and binning it wants
+// to show, the sparse one must not be added up or drawn.
+
+class OnlMonEventCounter
+{
+ public:
+  static constexpr int MAXPAIRS = 16384;
+
+  // server side: book an empty counter with room for npairs events
+  static TH1 *Book(const char *name, const char *title, const int npairs = 1024);
+  // server side: add count to event (ascending event numbers)
+  static void Fill(TH1 *h, const int event, const double count = 1);
+
+  // client side: fill the pairs into dense (which is reset first)
+  static void Render(const TH1 *h, TH1 *dense);
+
+  static int Pairs(const TH1 *h);
+  // number of events a pair stands for, 1 until the first Coarsen()
+  static int BlockWidth(const TH1 *h);
+  // largest event number with a count (end of its block), -1 if empty
+  static int LastEvent(const TH1 *h);
+
+ private:
+  static void Coarsen(TH1 *h);
+};
+
+#endif /* ONLMONSERVER_ONLMONEVENTCOUNTER_H */
@@ -0,0 +1,77 @@
+#ifndef ONLMONSERVER_ONLMONHISTORY_H
+#define ONLMONSERVER_ONLMONHISTORY_H
+
+#include <TH1.h>
+
+#include <algorithm>
+#include <vector>
+
+// Rolling history plots ("value vs time") kept in a TH1 used as a
+// circular buffer. The server writes each new value into the bin after the
+// last one and stores the position of the next write (the head) in the
+// underflow bin, so an update costs O(1) instead of shifting all bins.
+// The head travels with the histogram to the client, which has to call
+// Unroll() on the histogram of each server before adding or drawing it,
+// this puts the bins back into chronological order (oldest first) and
+// resets the head.
+// Header only since server and client libraries both use it, the client
+// libraries do not link libonlmonserver.
+
+class OnlMonHistory
+{
+ public:
+  // server side: append a value to the history
+  static void Fill(TH1 *h, const double value)
+  {
+    int nbins = h->GetNbinsX();
+    int head = Head(h);
+    h->SetBinContent(head + 1, value);
+    head++;
+    if (head >= nbins)
+    {
+      head = 0;
+    }
+    h->SetBinContent(0, head);
+    return;
+  }
+
+  // client side: rotate the bins into time order, the head is set to 0
+  static void Unroll(TH1 *h)
+  {
+    if (!h)
+    {
+      return;
+    }
+    int head = Head(h);
+    if (head == 0)
+    {
+      return;
+    }
+    int nbins = h->GetNbinsX();
+    std::vector<double> content(nbins);
+    for (int ib = 0; ib < nbins; ib++)
+    {
+      content[ib] = h->GetBinContent(ib + 1);
+    }
+    // the oldest entry sits at the head
+    std::rotate(content.begin(), content.begin() + head, content.end());
+    for (int ib = 0; ib < nbins; ib++)
+    {
+      h->SetBinContent(ib + 1, content[ib]);
+    }
+    h->SetBinContent(0, 0);
+    return;
+  }
+
+  static int Head(const TH1 *h)
+  {
+    int head = static_cast<int>(h->GetBinContent(0));
+    if (head < 0 || head >= h->GetNbinsX())
+    {
+      return 0;
+    }
+    return head;
+  }
+};
+
+#endif /* ONLMONSERVER_ONLMONHISTORY_H */
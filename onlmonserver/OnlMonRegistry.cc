@@ -0,0 +1,169 @@
+#include "OnlMonRegistry.h"
+
+#include <unistd.h>
+#include <cstdio>  // for rename
+#include <cstdlib>  // for getenv
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+  std::string entryFileName(const std::string &dir, const std::string &hostname, const int port)
+  {
+    return dir + "/" + hostname + "_" + std::to_string(port);
+  }
+
+  std::string shortHostName(const std::string &hostname)
+  {
+    std::string host = (hostname == "localhost") ? OnlMonRegistry::LocalHostName() : hostname;
+    return host.substr(0, host.find('.'));
+  }
+}  // namespace
+
+std::string OnlMonRegistry::Directory()
+{
+  const char *dir = getenv("ONLMON_REGISTRY");
+  if (!dir)
+  {
+    return "";
+  }
+  return dir;
+}
+
+std::string OnlMonRegistry::LocalHostName()
+{
+  char hostname[256];
+  if (gethostname(hostname, sizeof(hostname)))
+  {
+    return "localhost";
+  }
+  hostname[sizeof(hostname) - 1] = '\0';
+  return hostname;
+}
+
+bool OnlMonRegistry::SameHost(const std::string &host1, const std::string &host2)
+{
+  return shortHostName(host1) == shortHostName(host2);
+}
+
+int OnlMonRegistry::Publish(const Entry &entry)
+{
+  std::string dir = Directory();
+  if (dir.empty())
+  {
+    return 0;
+  }
+  std::string filename = entryFileName(dir, entry.hostname, entry.port);
+  // readers only ever see complete files
+  std::string tmpfilename = dir + "/." + entry.hostname + "_" + std::to_string(entry.port) + ".tmp";
+  std::ofstream regfile(tmpfilename);
+  if (!regfile.is_open())
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot write " << tmpfilename << std::endl;
+    return -1;
+  }
+  regfile << "host " << entry.hostname << std::endl;
+  regfile << "port " << entry.port << std::endl;
+  regfile << "started " << entry.started << std::endl;
+  regfile << "heartbeat " << entry.heartbeat << std::endl;
+  for (auto &monitor : entry.monitors)
+  {
+    regfile << "monitor " << monitor << std::endl;
+  }
+  for (auto &histo : entry.histos)
+  {
+    regfile << "histo " << histo.first << " " << histo.second << std::endl;
+  }
+  regfile.close();
+  if (regfile.fail() || rename(tmpfilename.c_str(), filename.c_str()))
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot update " << filename << std::endl;
+    std::filesystem::remove(tmpfilename);
+    return -1;
+  }
+  return 0;
+}
+
+int OnlMonRegistry::Remove(const std::string &hostname, const int port)
+{
+  std::string dir = Directory();
+  if (dir.empty())
+  {
+    return 0;
+  }
+  std::error_code ec;
+  std::filesystem::remove(entryFileName(dir, hostname, port), ec);
+  return 0;
+}
+
+int OnlMonRegistry::Read(std::vector<Entry> &entries)
+{
+  std::string dir = Directory();
+  if (dir.empty())
+  {
+    return -1;
+  }
+  std::error_code ec;
+  std::filesystem::directory_iterator diriter(dir, ec);
+  if (ec)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot read registry " << dir << ": " << ec.message() << std::endl;
+    return -1;
+  }
+  time_t now = time(nullptr);
+  int nentries = 0;
+  for (auto &regfile : diriter)
+  {
+    if (regfile.path().filename().string()[0] == '.')
+    {
+      continue;  // being written
+    }
+    std::ifstream infile(regfile.path());
+    Entry entry;
+    std::string line;
+    while (std::getline(infile, line))
+    {
+      std::istringstream iss(line);
+      std::string key;
+      iss >> key;
+      if (key == "host")
+      {
+        iss >> entry.hostname;
+      }
+      else if (key == "port")
+      {
+        iss >> entry.port;
+      }
+      else if (key == "started")
+      {
+        iss >> entry.started;
+      }
+      else if (key == "heartbeat")
+      {
+        iss >> entry.heartbeat;
+      }
+      else if (key == "monitor")
+      {
+        std::string monitor;
+        iss >> monitor;
+        entry.monitors.push_back(monitor);
+      }
+      else if (key == "histo")
+      {
+        std::string monitor;
+        std::string hname;
+        iss >> monitor >> hname;
+        entry.histos.push_back(std::make_pair(monitor, hname));
+      }
+    }
+    if (entry.hostname.empty() || entry.port <= 0 || now - entry.heartbeat > 3 * HEARTBEAT)
+    {
+      continue;
+    }
+    entries.push_back(entry);
+    nentries++;
+  }
+  return nentries;
+}
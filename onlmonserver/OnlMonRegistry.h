@@ -0,0 +1,53 @@
+#ifndef ONLMONSERVER_ONLMONREGISTRY_H
+#define ONLMONSERVER_ONLMONREGISTRY_H
+
+/**
+Registry of the running servers, so clients find a monitor with one
+lookup instead of connecting to every port of every host. Each server
+writes a small text file <dir>/<host>_<port> with its monitors and
+histograms when it starts listening and rewrites it every
+HEARTBEAT seconds (new histograms show up, the time shows it is alive).
+Entries without a heartbeat for 3 intervals are ignored, the server died
+without removing its file.
+
+The directory is given by $ONLMON_REGISTRY (shared between the server
+and client nodes). Without it nothing is written or read and the clients
+scan the ports as before. They also scan for monitors the registry does
+not list (older servers, servers which just started).
+*/
+
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+class OnlMonRegistry
+{
+ public:
+  static const unsigned int HEARTBEAT = 30;  // seconds
+
+  struct Entry
+  {
+    std::string hostname;
+    int port{0};
+    time_t started{0};
+    time_t heartbeat{0};
+    std::vector<std::string> monitors;
+    std::vector<std::pair<std::string, std::string>> histos;  // monitor, histogram
+  };
+
+  // empty if the registry is not used
+  static std::string Directory();
+  static std::string LocalHostName();
+  // host names as given to the clients (ebdc00, ebdc00.sphenix.bnl.gov, localhost)
+  static bool SameHost(const std::string &host1, const std::string &host2);
+
+  // server side, the file is replaced atomically
+  static int Publish(const Entry &entry);
+  static int Remove(const std::string &hostname, const int port);
+
+  // client side, returns the number of live entries (-1 if the registry is not used)
+  static int Read(std::vector<Entry> &entries);
+};
+
+#endif /* ONLMONSERVER_ONLMONREGISTRY_H */
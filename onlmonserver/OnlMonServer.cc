@@ -1,14 +1,17 @@
 #include "OnlMonServer.h"
 
 #include "OnlMon.h"
+#include "OnlMonShm.h"
 #include "OnlMonStatusDB.h"
 
 #include "MessageSystem.h"
 
 #include <Event/msg_profile.h>  // for MSG_SEV_ERROR, MSG_SEV...
 
+#include <MessageTypes.h>  // for kMESS_OBJECT
 #include <TFile.h>
 #include <TH1.h>
+#include <TMessage.h>
 #include <TROOT.h>
 
 #include <odbc++/connection.h>
@@ -54,6 +57,11 @@ OnlMonServer::OnlMonServer(const std::string &name)
 #ifdef USE_MUTEX
   pthread_mutex_init(&mutex, nullptr);
 #endif
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&histomutex, &attr);
+  pthread_mutexattr_destroy(&attr);
   MsgSystem[ThisName] = new MessageSystem(ThisName);
   statusDB = new OnlMonStatusDB();
   RunStatusDB = new OnlMonStatusDB("onlmonrunstatus");
@@ -71,10 +79,12 @@ OnlMonServer::~OnlMonServer()
     std::cout << __PRETTY_FUNCTION__ << "pthread cancel returned error: " << tret << std::endl;
   }
   delete serverrunning;
+  delete shm.exchange(nullptr);
 
 #ifdef USE_MUTEX
   pthread_mutex_destroy(&mutex);
 #endif
+  pthread_mutex_destroy(&histomutex);
   while (MonitorList.begin() != MonitorList.end())
   {
     delete MonitorList.back();
@@ -146,7 +156,9 @@ void OnlMonServer::dumpHistos(const std::string &filename)
 
 void OnlMonServer::registerCommonHisto(TH1 *h1d)
 {
+  LockHistos();
   CommonHistoMap.insert(std::make_pair(h1d->GetName(), h1d));
+  UnlockHistos();
   return;
 }
 
@@ -163,6 +175,7 @@ void OnlMonServer::registerHisto(const std::string &monitorname, const std::stri
     std::cout << "No empty spaces in registered histogram names : " << hname << std::endl;
     exit(1);
   }
+  LockHistos();
   auto moniiter = MonitorHistoSet.find(monitorname);
   if (moniiter == MonitorHistoSet.end())
   {
@@ -170,6 +183,7 @@ void OnlMonServer::registerHisto(const std::string &monitorname, const std::stri
     histo[hname] = h1d;
     std::cout << __PRETTY_FUNCTION__ << " inserting " << monitorname << " hname " << hname << std::endl;
     MonitorHistoSet.insert(std::make_pair(monitorname, histo));
+    UnlockHistos();
     return;
   }
   auto histoiter = moniiter->second.find(hname);
@@ -190,6 +204,7 @@ void OnlMonServer::registerHisto(const std::string &monitorname, const std::stri
                 << ", it will not be overwritten" << std::endl;
     }
   }
+  UnlockHistos();
   return;
 }
 
@@ -274,7 +289,9 @@ void OnlMonServer::registerMonitor(OnlMon *Monitor)
       return;
     }
   }
+  LockHistos();
   MonitorList.push_back(Monitor);
+  UnlockHistos();
   MsgSystem[Monitor->Name()] = new MessageSystem(Monitor->Name());
   Monitor->InitCommon(this);
   Monitor->Init();
@@ -571,6 +588,53 @@ int OnlMonServer::WriteHistoFile()
   return 0;
 }
 
+void OnlMonServer::CreateSharedMemory()
+{
+  if (!shm)
+  {
+    shm = OnlMonShm::Create(PortNumber());
+  }
+  return;
+}
+
+void OnlMonServer::PublishSharedMemory()
+{
+  OnlMonShm *segment = shm.load();
+  if (!segment || time(nullptr) - shmpublished < OnlMonShm::INTERVAL || !segment->HasReaders())
+  {
+    return;
+  }
+  // the event loop must not wait for a client being served, the next event tries again
+  if (!TryLockHistos())
+  {
+    return;
+  }
+  shmpublished = time(nullptr);
+  // same bytes which go over the socket
+  TMessage outgoing(kMESS_OBJECT);
+  int nfailed = 0;
+  for (auto &moniiter : MonitorHistoSet)
+  {
+    for (auto &histiter : moniiter.second)
+    {
+      outgoing.Reset();
+      outgoing.WriteObject(histiter.second);
+      outgoing.SetLength();
+      if (segment->Publish(moniiter.first, histiter.first, outgoing.Buffer(), outgoing.Length()))
+      {
+        nfailed++;
+      }
+    }
+  }
+  UnlockHistos();
+  if (nfailed > 0 && Verbosity() > 0)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " shared memory full, "
+              << nfailed << " histograms are only served over the socket" << std::endl;
+  }
+  return;
+}
+
 int OnlMonServer::send_message(const OnlMon *Monitor, const int msgsource, const int severity, const std::string &err_message, const int msgtype) const
 {
   int iret = -1;
@@ -7,6 +7,7 @@
 #include "OnlMonDefs.h"
 
 #include <pthread.h>
+#include <atomic>
 #include <ctime>
 #include <iostream>
 #include <limits>
@@ -18,6 +19,7 @@
 class Event;
 class MessageSystem;
 class OnlMon;
+class OnlMonShm;
 class OnlMonStatusDB;
 class TH1;
 
@@ -69,6 +71,15 @@ class OnlMonServer : public OnlMonBase
   void CurrentTicks(const time_t ival) { currentticks = ival; }
   time_t BorTicks() const { return borticks; }
   void BorTicks(const time_t ival) { borticks = ival; }
+  // generation of this server, changes with every restart (see GENERATION request)
+  time_t StartTicks() const { return startticks; }
+
+  // histogram snapshots in shared memory for clients on this node (see OnlMonShm.h),
+  // the segment is created by the server thread once the port is known
+  void CreateSharedMemory();
+  // at most every OnlMonShm::INTERVAL seconds and only while a client reads the
+  // segment, skipped (not waited for) while the server thread holds the histograms
+  void PublishSharedMemory();
 
   int BadEvents() const { return badevents; }
   void AddBadEvent() { badevents++; }
@@ -89,6 +100,12 @@ class OnlMonServer : public OnlMonBase
 #ifdef USE_MUTEX
   void GetMutex(pthread_mutex_t &lock) { lock = mutex; }
 #endif
+  // guards the histogram maps and the histograms against the server thread
+  // (always compiled, unlike USE_MUTEX which also serializes the event loop),
+  // recursive so registerHisto() can be called with it held
+  void LockHistos() { pthread_mutex_lock(&histomutex); }
+  bool TryLockHistos() { return pthread_mutex_trylock(&histomutex) == 0; }
+  void UnlockHistos() { pthread_mutex_unlock(&histomutex); }
   void SetThreadId(const pthread_t &id) { serverthreadid = id; }
 
   //int LoadActivePackets();
@@ -120,6 +137,7 @@ class OnlMonServer : public OnlMonBase
   int badevents {0};
   time_t currentticks {0};
   time_t borticks {0};
+  time_t startticks {time(nullptr)};
   int activepacketsinit {0};
   unsigned int scaledtrigmask {std::numeric_limits<unsigned int>::max()};
   int scaledtrigmask_used {0};
@@ -128,7 +146,10 @@ class OnlMonServer : public OnlMonBase
   std::string TriggerConfig {"UNKNOWN"};
   std::string RunType {"UNKNOWN"};
 
+  time_t shmpublished {0};
+
   TH1 *serverrunning {nullptr};
+  std::atomic<OnlMonShm *> shm {nullptr};
   OnlMonStatusDB *statusDB {nullptr};
   OnlMonStatusDB *RunStatusDB {nullptr};
   std::map<const std::string, TH1 *> CommonHistoMap;
@@ -137,6 +158,7 @@ class OnlMonServer : public OnlMonBase
   std::map<std::string, MessageSystem *> MsgSystem;
   std::map<std::string, std::map<std::string, TH1 *>> MonitorHistoSet;
   pthread_mutex_t mutex;
+  pthread_mutex_t histomutex;
   pthread_t serverthreadid {0};
 };
 
@@ -0,0 +1,397 @@
+#include "OnlMonShm.h"
+
+#include <TMessage.h>
+
+#include <fcntl.h>  // for O_CREAT, O_RDONLY, O_RDWR
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>  // for getenv, strtol
+#include <cstring>  // for memcpy, strncpy
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <thread>
+
+namespace
+{
+  const char SHMMAGIC[8] = {'O', 'N', 'L', 'M', 'S', 'H', 'M', '\0'};
+  const uint32_t SHMVERSION = 3;
+  const uint32_t MAXSLOTS = 16384;
+  const size_t DEFAULTSIZE = 256;  // MB
+
+  // the messages are read from a buffer which did not come from a socket
+  class ShmMessage : public TMessage
+  {
+   public:
+    ShmMessage(void *buf, Int_t len)
+      : TMessage(buf, len)
+    {
+    }
+  };
+}  // namespace
+
+struct OnlMonShm::Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t maxslots;
+  std::atomic<uint32_t> nslots;  // slots in use, only grows
+  uint64_t dataoffset;           // start of the histogram data
+};
+
+struct OnlMonShm::Slot
+{
+  char name[192];  // "<monitor> <histo>"
+  std::atomic<uint64_t> seq;
+  uint64_t offset;
+  uint32_t length;
+  int64_t published;  // time of the snapshot
+};
+
+struct OnlMonShm::Readers
+{
+  std::atomic<int64_t> readtime;  // last read of a client, written by the clients
+};
+
+std::string OnlMonShm::SegmentName(const int port)
+{
+  return "/onlmon_" + std::to_string(port);
+}
+
+std::string OnlMonShm::ReadersName(const int port)
+{
+  return SegmentName(port) + "_readers";
+}
+
+OnlMonShm::Readers *OnlMonShm::MapReaders(const int port, const bool create)
+{
+  std::string name = ReadersName(port);
+  int fd = -1;
+  if (create)
+  {
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0666);
+    if (fd >= 0)
+    {
+      fchmod(fd, 0666);  // clients of other accounts stamp their reads, the umask would prevent that
+      if (ftruncate(fd, sizeof(Readers)) != 0)
+      {
+        close(fd);
+        fd = -1;
+      }
+    }
+  }
+  else
+  {
+    fd = shm_open(name.c_str(), O_RDWR, 0);
+  }
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat st;
+  void *base = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(Readers)))
+  {
+    base = mmap(nullptr, sizeof(Readers), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (base == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  Readers *readers = static_cast<Readers *>(base);
+  if (create)
+  {
+    new (readers) Readers();
+    readers->readtime.store(0);
+  }
+  return readers;
+}
+
+OnlMonShm *OnlMonShm::Create(const int port)
+{
+  const char *shmenv = getenv("ONLMON_SHM");
+  if (!shmenv)
+  {
+    return nullptr;
+  }
+  size_t megabytes = strtol(shmenv, nullptr, 10);
+  if (megabytes == 0)
+  {
+    megabytes = DEFAULTSIZE;
+  }
+  std::string name = SegmentName(port);
+  shm_unlink(name.c_str());  // clients still mapping the old one see that it is gone
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot create shared memory " << name << std::endl;
+    return nullptr;
+  }
+  size_t size = megabytes * 1024 * 1024;
+  struct stat st;
+  void *base = MAP_FAILED;
+  if (ftruncate(fd, size) == 0 && fstat(fd, &st) == 0)
+  {
+    base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (base == MAP_FAILED)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot map " << megabytes << " MB of shared memory " << name << std::endl;
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  OnlMonShm *shm = new OnlMonShm();
+  shm->m_Base = static_cast<char *>(base);
+  shm->m_Size = size;
+  shm->m_Port = port;
+  shm->m_Owner = true;
+  shm->m_Inode = st.st_ino;
+  Header *header = new (shm->m_Base) Header();
+  header->version = SHMVERSION;
+  header->maxslots = MAXSLOTS;
+  header->nslots.store(0);
+  header->dataoffset = sizeof(Header) + MAXSLOTS * sizeof(Slot);
+  shm->m_DataUsed = header->dataoffset;
+  shm->m_Readers = MapReaders(port, true);
+  if (!shm->m_Readers)
+  {
+    std::cout << __PRETTY_FUNCTION__ << " cannot create " << ReadersName(port)
+              << ", publishing without waiting for readers" << std::endl;
+  }
+  // readers check the magic, it goes in last
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(header->magic, SHMMAGIC, sizeof(SHMMAGIC));
+  return shm;
+}
+
+void OnlMonShm::Remove(const int port)
+{
+  shm_unlink(SegmentName(port).c_str());
+  shm_unlink(ReadersName(port).c_str());
+}
+
+OnlMonShm *OnlMonShm::Open(const int port)
+{
+  std::string name = SegmentName(port);
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat st;
+  void *base = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > static_cast<off_t>(sizeof(Header)))
+  {
+    base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (base == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  OnlMonShm *shm = new OnlMonShm();
+  shm->m_Base = static_cast<char *>(base);
+  shm->m_Size = st.st_size;
+  shm->m_Port = port;
+  shm->m_Inode = st.st_ino;
+  const Header *header = reinterpret_cast<const Header *>(shm->m_Base);
+  if (memcmp(header->magic, SHMMAGIC, sizeof(SHMMAGIC)) || header->version != SHMVERSION)
+  {
+    delete shm;
+    return nullptr;
+  }
+  // without it we can read, but the server does not know and will not publish
+  shm->m_Readers = MapReaders(port, false);
+  if (shm->m_Readers)
+  {
+    // the server starts publishing, the first snapshot comes within INTERVAL
+    shm->m_Readers->readtime.store(time(nullptr), std::memory_order_relaxed);
+  }
+  return shm;
+}
+
+OnlMonShm::~OnlMonShm()
+{
+  if (m_Base)
+  {
+    munmap(m_Base, m_Size);
+  }
+  if (m_Readers)
+  {
+    munmap(m_Readers, sizeof(Readers));
+  }
+  if (m_Owner)
+  {
+    Remove(m_Port);
+  }
+}
+
+bool OnlMonShm::HasReaders() const
+{
+  if (!m_Readers)
+  {
+    return true;  // nobody can tell us
+  }
+  return time(nullptr) - m_Readers->readtime.load(std::memory_order_relaxed) < READERTIMEOUT;
+}
+
+bool OnlMonShm::IsCurrent() const
+{
+  int fd = shm_open(SegmentName(m_Port).c_str(), O_RDONLY, 0);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat st;
+  bool current = (fstat(fd, &st) == 0 && st.st_ino == m_Inode);
+  close(fd);
+  return current;
+}
+
+OnlMonShm::Slot *OnlMonShm::GetSlot(const std::string &name)
+{
+  Header *header = reinterpret_cast<Header *>(m_Base);
+  Slot *slots = reinterpret_cast<Slot *>(m_Base + sizeof(Header));
+  // slots are only added, pick up the ones the server added since the last time
+  uint32_t nslots = std::min(header->nslots.load(std::memory_order_acquire), header->maxslots);
+  for (; m_Indexed < nslots; m_Indexed++)
+  {
+    m_Index[std::string(slots[m_Indexed].name, strnlen(slots[m_Indexed].name, sizeof(slots[m_Indexed].name)))] = m_Indexed;
+  }
+  auto iter = m_Index.find(name);
+  if (iter == m_Index.end())
+  {
+    return nullptr;
+  }
+  return &slots[iter->second];
+}
+
+uint64_t OnlMonShm::Allocate(const uint32_t capacity)
+{
+  if (m_DataUsed + capacity > m_Size)
+  {
+    return 0;
+  }
+  uint64_t offset = m_DataUsed;
+  m_DataUsed += capacity;
+  return offset;
+}
+
+OnlMonShm::Slot *OnlMonShm::NewSlot(const std::string &name, const uint32_t len)
+{
+  Header *header = reinterpret_cast<Header *>(m_Base);
+  uint32_t islot = m_Space.size();
+  if (islot >= MAXSLOTS || name.size() >= sizeof(Slot::name))
+  {
+    return nullptr;
+  }
+  // room to grow, histograms rarely change their size
+  uint32_t capacity = std::max(len + len / 2, 4096U);
+  uint64_t offset = Allocate(capacity);
+  if (!offset)
+  {
+    return nullptr;
+  }
+  Slot *slot = reinterpret_cast<Slot *>(m_Base + sizeof(Header)) + islot;
+  new (slot) Slot();
+  strncpy(slot->name, name.c_str(), sizeof(slot->name) - 1);
+  slot->seq.store(0, std::memory_order_relaxed);
+  slot->offset = offset;
+  slot->length = 0;
+  slot->published = 0;
+  header->nslots.store(islot + 1, std::memory_order_release);
+  m_Index[name] = islot;
+  m_Space.emplace_back(offset, capacity);
+  return slot;
+}
+
+int OnlMonShm::Publish(const std::string &monitor, const std::string &hname, const char *data, const uint32_t len)
+{
+  std::string name = monitor + ' ' + hname;
+  // our own index, the slot names in the segment are for the clients
+  Slot *slot = nullptr;
+  auto iter = m_Index.find(name);
+  if (iter != m_Index.end())
+  {
+    slot = reinterpret_cast<Slot *>(m_Base + sizeof(Header)) + iter->second;
+  }
+  else
+  {
+    slot = NewSlot(name, len);
+    if (!slot)
+    {
+      return -1;  // segment full, this one goes over the socket
+    }
+    iter = m_Index.find(name);
+  }
+  std::pair<uint64_t, uint32_t> &space = m_Space[iter->second];
+  if (len > space.second)
+  {
+    // the old space is lost, this happens rarely enough
+    uint32_t capacity = len + len / 2;
+    uint64_t offset = Allocate(capacity);
+    if (!offset)
+    {
+      return -1;
+    }
+    space = std::make_pair(offset, capacity);
+  }
+  if (space.first + len > m_Size)
+  {
+    return -1;
+  }
+  slot->seq.fetch_add(1, std::memory_order_acq_rel);  // odd: being written
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->offset = space.first;
+  memcpy(m_Base + space.first, data, len);
+  slot->length = len;
+  slot->published = time(nullptr);
+  slot->seq.fetch_add(1, std::memory_order_release);
+  return 0;
+}
+
+TMessage *OnlMonShm::Read(const std::string &monitor, const std::string &hname)
+{
+  time_t now = time(nullptr);
+  if (m_Readers)
+  {
+    m_Readers->readtime.store(now, std::memory_order_relaxed);
+  }
+  Slot *slot = GetSlot(monitor + ' ' + hname);
+  if (!slot)
+  {
+    return nullptr;
+  }
+  for (int itry = 0; itry < 100; itry++)
+  {
+    uint64_t seq = slot->seq.load(std::memory_order_acquire);
+    if (seq & 1)
+    {
+      std::this_thread::yield();  // server is writing this one
+      continue;
+    }
+    uint64_t offset = slot->offset;
+    uint32_t len = slot->length;
+    // the server stopped publishing while nobody read, this one is from back then
+    if (len == 0 || offset + len > m_Size || now - slot->published > MAXAGE)
+    {
+      return nullptr;
+    }
+    char *buf = new char[len];
+    memcpy(buf, m_Base + offset, len);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->seq.load(std::memory_order_relaxed) != seq)
+    {
+      delete[] buf;  // overwritten while we copied it
+      continue;
+    }
+    return new ShmMessage(buf, len);  // adopts buf
+  }
+  return nullptr;
+}
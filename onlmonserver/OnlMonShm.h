@@ -0,0 +1,88 @@
+#ifndef ONLMONSERVER_ONLMONSHM_H
+#define ONLMONSERVER_ONLMONSHM_H
+
+/**
+Shared memory transport for clients on the same node as the server (the
+html generator runs next to the servers). The server publishes a snapshot
+of every histogram, serialized like for the socket, into the segment
+/onlmon_<port> at most every INTERVAL seconds, but only while a client
+has read from it within the last READERTIMEOUT seconds. Clients map the
+segment read-only and stamp their reads into the small segment
+/onlmon_<port>_readers, the only one they can write; the server keeps
+the layout of the data segment in its own memory and never trusts what
+it reads back from shared memory. Clients skip the socket for what they
+find there. Each histogram has a slot with a sequence counter (seqlock):
+it is odd while the server writes, readers copy the bytes out and retry
+if the counter changed in the meantime. Snapshots older than MAXAGE
+(the server stopped publishing) are ignored.
+
+Enabled by $ONLMON_SHM on the server (segment size in MB, 256 if it is
+not a number) and OnlMonClient::UseSharedMemory() on the client.
+Histograms which are not in the segment (not published yet, segment
+full) are fetched over the socket.
+*/
+
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TMessage;
+
+class OnlMonShm
+{
+ public:
+  static const unsigned int INTERVAL = 2;         // seconds between snapshots
+  static const unsigned int READERTIMEOUT = 60;   // no snapshots if nobody read for that long
+  static const unsigned int MAXAGE = 2 * INTERVAL;  // older snapshots are not served
+
+  ~OnlMonShm();
+
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit OnlMonShm(const OnlMonShm &) = delete;
+  OnlMonShm &operator=(const OnlMonShm &) = delete;
+
+  // server side, replaces a segment left behind by a previous server on this port
+  static OnlMonShm *Create(const int port);
+  static void Remove(const int port);
+  int Publish(const std::string &monitor, const std::string &hname, const char *data, const uint32_t len);
+  // a client read from the segment within READERTIMEOUT
+  bool HasReaders() const;
+
+  // client side
+  static OnlMonShm *Open(const int port);
+  // false if the server was restarted (new segment) since Open()
+  bool IsCurrent() const;
+  // newest snapshot of the histogram, nullptr if it is not there
+  TMessage *Read(const std::string &monitor, const std::string &hname);
+
+ private:
+  struct Header;
+  struct Slot;
+  struct Readers;
+
+  OnlMonShm() = default;
+  static std::string SegmentName(const int port);
+  static std::string ReadersName(const int port);
+  static Readers *MapReaders(const int port, const bool create);
+  Slot *GetSlot(const std::string &name);
+  Slot *NewSlot(const std::string &name, const uint32_t len);
+  uint64_t Allocate(const uint32_t capacity);
+
+  char *m_Base{nullptr};
+  size_t m_Size{0};
+  Readers *m_Readers{nullptr};  // read times of the clients
+  int m_Port{0};
+  bool m_Owner{false};
+  ino_t m_Inode{0};
+  uint32_t m_Indexed{0};
+  std::map<std::string, uint32_t> m_Index;  // "<monitor> <histo>" -> slot
+  // server: offset and capacity of each slot, never read back from the segment
+  std::vector<std::pair<uint64_t, uint32_t>> m_Space;
+  uint64_t m_DataUsed{0};
+};
+
+#endif /* ONLMONSERVER_ONLMONSHM_H */
@@ -6,7 +6,9 @@
 #include "HistoBinDefs.h"
 #include "OnlMon.h"
 #include "OnlMonDefs.h"
+#include "OnlMonRegistry.h"
 #include "OnlMonServer.h"
+#include "OnlMonShm.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -37,10 +39,12 @@
 #include <cstdio>       // for printf, NULL
 #include <cstdlib>      // for exit
 #include <cstring>      // for strcmp
+#include <ctime>
 #include <iostream>     // for operator<<, basic_ostream, endl, basic_o...
 #include <limits>
 #include <sstream>
 #include <string>
+#include <utility>
 
 //#define ROOTTHREAD
 
@@ -62,6 +66,8 @@ static TThread *ServerThread = nullptr;
 pthread_mutex_t mutex;
 #endif
 
+static void *registry(void *);
+
 TH1 *FrameWorkVars = nullptr;
 void signalhandler(int signum);
 //*********************************************************************
@@ -231,6 +237,7 @@ int process_event(Event *evt)
   FrameWorkVars->SetBinContent(EVENTCOUNTERBIN,se->EventCounter());
   se->process_event(evt);
   FrameWorkVars->SetBinContent(GL1COUNTERBIN,se->Gl1FoundCounter());
+  se->PublishSharedMemory();
 #ifdef USE_MUTEX
   pthread_mutex_unlock(&mutex);
 #endif
@@ -283,9 +290,15 @@ static void *server(void * /* arg */)
   int isock = gROOT->GetListOfSockets()->IndexOf(ss);
   gROOT->GetListOfSockets()->RemoveAt(isock);
   sleep(10);
+  Onlmonserver->CreateSharedMemory();
 #ifdef USE_MUTEX
   pthread_mutex_unlock(&mutex);
 #endif
+  if (!OnlMonRegistry::Directory().empty())
+  {
+    pthread_t RegistryThreadId = 0;
+    pthread_create(&RegistryThreadId, nullptr, registry, (void *) nullptr);
+  }
 again:
   TSocket *s0 = ss->Accept();
   if (!s0)
@@ -310,7 +323,9 @@ again:
   pthread_mutex_lock(&mutex);
 #endif
   // std::cout << "got mutex" << std::endl;
+  Onlmonserver->LockHistos();
   handleconnection(s0);
+  Onlmonserver->UnlockHistos();
   // std::cout << "try releasing mutex" << std::endl;
 #ifdef USE_MUTEX
   pthread_mutex_unlock(&mutex);
@@ -330,6 +345,39 @@ again:
   goto again;
 }
 
+// publishes monitors and histograms of this server in the registry
+// (see OnlMonRegistry.h) and keeps its heartbeat going
+static void *registry(void * /* arg */)
+{
+  OnlMonServer *Onlmonserver = OnlMonServer::instance();
+  OnlMonRegistry::Entry entry;
+  entry.hostname = OnlMonRegistry::LocalHostName();
+  entry.port = Onlmonserver->PortNumber();
+  entry.started = Onlmonserver->StartTicks();
+  while (true)
+  {
+    entry.monitors.clear();
+    entry.histos.clear();
+    Onlmonserver->LockHistos();  // registerHisto() may change the maps meanwhile
+    for (auto moniter = Onlmonserver->monitor_vec_begin(); moniter != Onlmonserver->monitor_vec_end(); ++moniter)
+    {
+      entry.monitors.push_back((*moniter)->Name());
+    }
+    for (auto monitors = Onlmonserver->monibegin(); monitors != Onlmonserver->moniend(); ++monitors)
+    {
+      for (auto &histos : monitors->second)
+      {
+        entry.histos.push_back(std::make_pair(monitors->first, histos.first));
+      }
+    }
+    Onlmonserver->UnlockHistos();
+    entry.heartbeat = time(nullptr);
+    OnlMonRegistry::Publish(entry);
+    sleep(OnlMonRegistry::HEARTBEAT);
+  }
+  return nullptr;
+}
+
 void handletest(void * /* arg */)
 {
   //  std::cout << "threading" << std::endl;
@@ -440,6 +488,26 @@ void handleconnection(void *arg)
         }
         s0->Send("Finished");
       }
+      else if (str.find("GENERATION") == 0)
+      {
+        // start time of this server if it runs the monitor, clients compare
+        // it with their cached histogram locations to recognize a restart
+        std::string answer = "No";
+        std::string moniname = str.substr(str.find(' ') + 1);
+        for (auto moniter = Onlmonserver->monitor_vec_begin(); moniter != Onlmonserver->monitor_vec_end(); ++moniter)
+        {
+          if ((*moniter)->Name() == moniname)
+          {
+            answer = std::to_string(Onlmonserver->StartTicks());
+            break;
+          }
+        }
+        if (Onlmonserver->Verbosity() > 2)
+        {
+          std::cout << "got " << str << ", replied " << answer << std::endl;
+        }
+        s0->Send(answer.c_str());
+      }
       else if (str.find("ISRUNNING") != std::string::npos)
       {
         std::string answer = "No";
@@ -573,5 +641,7 @@ void signalhandler(int signum)
   std::cout << "Signal " << signum << " received, saving histos" << std::endl;
   OnlMonServer *Onlmonserver = OnlMonServer::instance();
   Onlmonserver->WriteHistoFile();
+  OnlMonRegistry::Remove(OnlMonRegistry::LocalHostName(), Onlmonserver->PortNumber());
+  OnlMonShm::Remove(Onlmonserver->PortNumber());
   gSystem->Exit(0);
 }
@@ -0,0 +1,128 @@
+#include "CaloPacketDecoder.h"
+
+#include <caloreco/CaloWaveformFitting.h>
+
+#include <Event/packet.h>
+
+#include <algorithm>
+
+CaloPacketDecoder::CaloPacketDecoder()
+{
+  m_Fitter = new CaloWaveformFitting();
+}
+
+CaloPacketDecoder::~CaloPacketDecoder()
+{
+  delete m_Fitter;
+}
+
+int CaloPacketDecoder::Decode(Packet *p)
+{
+  m_NChannels = 0;
+  m_NSamples = 0;
+  int nChannels = std::max(p->iValue(0, "CHANNELS"), 0);
+  int nSamples = std::max(p->iValue(0, "SAMPLES"), 0);
+  m_Samples.resize(nChannels * nSamples);
+  m_Suppressed.resize(nChannels);
+  m_Pre.resize(nChannels);
+  m_Post.resize(nChannels);
+  m_Fits.resize(nChannels);
+  for (int c = 0; c < nChannels; c++)
+  {
+    float *samples = &m_Samples[c * nSamples];
+    m_Suppressed[c] = (p->iValue(c, "SUPPRESSED") != 0);
+    if (m_Suppressed[c])
+    {
+      m_Pre[c] = p->iValue(c, "PRE");
+      m_Post[c] = p->iValue(c, "POST");
+      std::fill(samples, samples + nSamples, 0);
+    }
+    else
+    {
+      m_Pre[c] = 0;
+      m_Post[c] = 0;
+      for (int s = 0; s < nSamples; s++)
+      {
+        samples[s] = p->iValue(s, c);
+      }
+    }
+  }
+  m_NChannels = nChannels;
+  m_NSamples = nSamples;
+  return nChannels;
+}
+
+void CaloPacketDecoder::fillWaveform(const int channel, const int first, const int last, std::vector<float> &waveform) const
+{
+  waveform.clear();  // keeps the capacity from the previous event
+  if (m_Suppressed[channel] && m_SuppressedAsPrePost)
+  {
+    waveform.push_back(m_Pre[channel]);
+    waveform.push_back(m_Post[channel]);
+    return;
+  }
+  const float *samples = getWaveform(channel);
+  waveform.assign(samples + first, samples + last);
+  return;
+}
+
+void CaloPacketDecoder::toFit(const std::vector<float> &result, CaloFastFit &fit)
+{
+  fit = CaloFastFit();
+  if (result.size() > 0)
+  {
+    fit.amplitude = result[0];
+  }
+  if (result.size() > 1)
+  {
+    fit.time = result[1];
+  }
+  if (result.size() > 2)
+  {
+    fit.pedestal = result[2];
+  }
+  return;
+}
+
+int CaloPacketDecoder::FitFast()
+{
+  m_Waveforms.resize(m_NChannels);
+  for (int c = 0; c < m_NChannels; c++)
+  {
+    fillWaveform(c, 0, m_NSamples, m_Waveforms[c]);
+  }
+  std::vector<std::vector<float>> results = m_Fitter->calo_processing_fast(m_Waveforms);
+  for (int c = 0; c < m_NChannels; c++)
+  {
+    if (c < static_cast<int>(results.size()))
+    {
+      toFit(results[c], m_Fits[c]);
+    }
+    else
+    {
+      m_Fits[c] = CaloFastFit();
+    }
+  }
+  return 0;
+}
+
+int CaloPacketDecoder::FitFast(const int channel, const int low, const int high, CaloFastFit &fit)
+{
+  if (channel < 0 || channel >= m_NChannels)
+  {
+    fit = CaloFastFit();
+    return -1;
+  }
+  int first = std::max(low, 0);
+  int last = std::max(std::min(high, m_NSamples), first);
+  m_Waveforms.resize(1);
+  fillWaveform(channel, first, last, m_Waveforms[0]);
+  std::vector<std::vector<float>> results = m_Fitter->calo_processing_fast(m_Waveforms);
+  if (results.empty())
+  {
+    fit = CaloFastFit();
+    return -1;
+  }
+  toFit(results[0], fit);
+  return 0;
+}
@@ -0,0 +1,108 @@
+#ifndef __CALOPACKETDECODER_H__
+#define __CALOPACKETDECODER_H__
+
+/**
+Decoder for the digitizer packets of the calorimeters (CEMC, HCAL, sEPD,
+ZDC/SMD).
+
+Decode() asks the packet for the number of channels and samples once and
+copies all samples into one contiguous channels x samples array, together
+with the zero suppression flag and the PRE/POST values of the suppressed
+channels. The monitors then loop over this array instead of asking the
+packet for every single sample (and for CHANNELS/SAMPLES in every loop
+condition). The arrays are kept between events, so after the first event
+decoding does not allocate.
+
+FitFast() runs the fast waveform fit of coresoftware
+(CaloWaveformFitting::calo_processing_fast) over all decoded channels in
+one call:
+
+\begin{verbatim}
+  Packet *p = evt->getPacket(6001);
+  if (p)
+  {
+    int nChannels = decoder->Decode(p);
+    if (nChannels > m_nChannels)
+    {
+      // corrupted packet, too many channels
+    }
+    decoder->FitFast();
+    for (int c = 0; c < nChannels; c++)
+    {
+      float signal = decoder->getFit(c).amplitude;
+    }
+    delete p;
+  }
+\end{verbatim}
+
+The samples of zero suppressed channels read 0. By default suppressed
+channels are handed to the fit as the {PRE, POST} pair (amplitude POST -
+PRE, like CEMC and HCAL did it), SuppressedAsPrePost(false) fits their
+(all zero) samples instead, like ZDC, sEPD and LocalPol did it.
+
+*/
+
+#include <vector>
+
+class CaloWaveformFitting;
+class Packet;
+
+struct CaloFastFit
+{
+  float amplitude{0};
+  float time{0};
+  float pedestal{0};
+};
+
+class CaloPacketDecoder
+{
+ public:
+  CaloPacketDecoder();
+  ~CaloPacketDecoder();
+
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit CaloPacketDecoder(const CaloPacketDecoder &) = delete;
+  CaloPacketDecoder &operator=(const CaloPacketDecoder &) = delete;
+
+  /// decodes all channels of the packet, returns the number of channels
+  int Decode(Packet *p);
+
+  /// fit zero suppressed channels as {PRE, POST} (default) or as their samples
+  void SuppressedAsPrePost(const bool b) { m_SuppressedAsPrePost = b; }
+
+  /// fast fit of all decoded channels, results via getFit(ch)
+  int FitFast();
+
+  /// fast fit of the samples [low, high) of one channel only, the time is counted from low
+  int FitFast(const int channel, const int low, const int high, CaloFastFit &fit);
+
+  int getNChannels() const { return m_NChannels; }
+  int getNSamples() const { return m_NSamples; }
+  bool isSuppressed(const int channel) const { return m_Suppressed[channel]; }
+  float getPre(const int channel) const { return m_Pre[channel]; }
+  float getPost(const int channel) const { return m_Post[channel]; }
+
+  /// the getNSamples() samples of a channel
+  const float *getWaveform(const int channel) const { return &m_Samples[channel * m_NSamples]; }
+  float getSample(const int channel, const int sample) const { return m_Samples[channel * m_NSamples + sample]; }
+
+  const CaloFastFit &getFit(const int channel) const { return m_Fits[channel]; }
+
+ private:
+  // the waveform of channel c (samples [first, last)) as the fit wants it
+  void fillWaveform(const int channel, const int first, const int last, std::vector<float> &waveform) const;
+  static void toFit(const std::vector<float> &result, CaloFastFit &fit);
+
+  CaloWaveformFitting *m_Fitter{nullptr};
+  bool m_SuppressedAsPrePost{true};
+  int m_NChannels{0};
+  int m_NSamples{0};
+  std::vector<float> m_Samples;  // channels x samples, row-major
+  std::vector<char> m_Suppressed;
+  std::vector<float> m_Pre;
+  std::vector<float> m_Post;
+  std::vector<CaloFastFit> m_Fits;
+  std::vector<std::vector<float>> m_Waveforms;  // fit input, kept to reuse the memory
+};
+
+#endif
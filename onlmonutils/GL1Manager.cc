@@ -1,8 +1,6 @@
 
 #include "GL1Manager.h"
 
-#include <Event/eventReceiverClient.h>
-#include <Event/Event.h>
 #include <Event/packet.h>
 
 #include <algorithm>
@@ -16,20 +14,19 @@ GL1Manager::GL1Manager (const char * hostname, const int h, const int d)
 {
   _hostname = hostname;
   _broken = 0;
-  pgl1 = 0;
+  havegl1 = 0;
 
   history_length = h;
   max_discrepancy = d;
 
+  gl1service = nullptr;
   Reset();
 
-  erc = new eventReceiverClient(hostname);
+  gl1service = GL1Service::instance(hostname);
 }
 
 GL1Manager::~GL1Manager()
 {
-  if (pgl1) delete pgl1;
-  if ( erc) delete erc;
 }
 
 
@@ -40,7 +37,6 @@ void GL1Manager::Reset()
   clockdiff = 0;
   event_delta = 0;
   eventMatch = 0;
-  packetRequested = 0;
   gl1_clock = 0;
   init_done = 0;
   verbosity = 0;
@@ -51,20 +47,22 @@ void GL1Manager::Reset()
   diff_gl1clocks.clear();
   diff_packetclocks.clear();
 
-  if (pgl1) delete pgl1;
-  pgl1 = 0;
+  havegl1 = 0;
+
+  // event numbers start over, nothing cached for the previous run is valid
+  if (gl1service)
+  {
+    gl1service->Reset();
+  }
 
   return;
 }
 
 
-Packet *GL1Manager::getGL1Packet()
+const GL1Data *GL1Manager::getGL1Data() const
 {
-  if ( ! pgl1) return 0;
-  packetRequested = 1;
-  
-  return pgl1;
-
+  if ( ! havegl1) return 0;
+  return &gl1data;
 }
 
 
@@ -74,32 +72,12 @@ int GL1Manager::getClockSync(const int evtnr, Packet * p)
 }
 
 
-Packet * GL1Manager::fetchGL1Packet( const int evtnr)
+int GL1Manager::fetchGL1Data( const int evtnr)
 {
-  if (pgl1 && packetRequested == 0)  delete pgl1;
-  pgl1 = 0;
-  packetRequested = 0;
-
   coutfl << " asking for event " << evtnr + event_delta  << endl;
-  Event *gl1Event = erc->getEvent(evtnr + event_delta);
-
-  if ( !gl1Event) 
-    {
-      return 0;
-    }
-
-  pgl1 = gl1Event->getPacket(14001);
-  if ( ! pgl1)
-    {
-      delete gl1Event;
-      return 0;
-    }
-
-  pgl1->convert();
-
-  delete gl1Event;
-
-  return pgl1;
+  // the service has decoded packet 14001 already, most likely ahead of time
+  havegl1 = (gl1service->getGL1Data(evtnr + event_delta, gl1data) == 0);
+  return (havegl1) ? 0 : -1;
 }
 
 
@@ -107,11 +85,9 @@ Packet * GL1Manager::fetchGL1Packet( const int evtnr)
 int GL1Manager::ClockSync(const int evtnr, Packet * p)
 {
 
-  pgl1 = fetchGL1Packet(evtnr);
-  if ( !pgl1 ) return -1;
+  if ( fetchGL1Data(evtnr) ) return -1;
   
-  // if we are getting to the next event. delete what's left of the previous one, if any
-  gl1_clock = pgl1->lValue(0, "BCO"); 
+  gl1_clock = gl1data.bco;
   long long packet_clock = p->lValue(0, "CLOCK");
 
   // keep the 4 vectors trimmed at the envisioned size
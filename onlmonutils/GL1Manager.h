@@ -18,9 +18,8 @@ enum GL1ManagerReturnCodes
 
 
 
-//#include <Event/eventReceiverClient.h>
+#include "GL1Service.h"
 
-class eventReceiverClient;
 class Packet;
 
 
@@ -28,7 +27,7 @@ class GL1Manager
 {
  public:
 
-  GL1Manager (const char * /*hostname*/, const int /*history*/ = 6, const int /*maxdiscrepancy*/ = 3); // for eventReceiverclient
+  GL1Manager (const char * /*hostname*/, const int /*history*/ = 6, const int /*maxdiscrepancy*/ = 3); // for the GL1Service of this host
   ~GL1Manager();
 
   void Reset();
@@ -42,23 +41,24 @@ class GL1Manager
   int checkPacket (Packet * /*p*/) const;
   uint32_t getPacketClockDifference (Packet * /*p*/) const;
 
-  Packet * getGL1Packet();
+  // the decoded GL1 packet of the last event, nullptr if there was none
+  const GL1Data * getGL1Data() const;
 
  protected:
 
   // the generic function
   int ClockSync(const int evtnr, Packet * p);
-  Packet * fetchGL1Packet(const int /*evtnr*/);
+  int fetchGL1Data(const int /*evtnr*/);
   int findDelta();
   
-  Packet *pgl1;
+  GL1Data gl1data;
+  int havegl1;
 
   std::string _hostname;
 
   int eventMatch;
-  int packetRequested;
 
-  eventReceiverClient *erc;
+  GL1Service *gl1service;
   uint32_t desireddiff;
   uint32_t previousdiff;
   uint32_t clockdiff;
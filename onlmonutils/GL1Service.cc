@@ -0,0 +1,214 @@
+
+#include "GL1Service.h"
+
+#include <Event/Event.h>
+#include <Event/eventReceiverClient.h>
+#include <Event/packet.h>
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+std::map<std::string, GL1Service *> GL1Service::services;
+std::mutex GL1Service::servicesMutex;
+
+GL1Service *GL1Service::instance(const std::string &hostname)
+{
+  std::lock_guard<std::mutex> lock(servicesMutex);
+  auto iter = services.find(hostname);
+  if (iter != services.end())
+  {
+    return iter->second;
+  }
+  GL1Service *service = new GL1Service(hostname);
+  services[hostname] = service;
+  return service;
+}
+
+GL1Service::GL1Service(const std::string &hostname)
+  : _hostname(hostname)
+{
+  erc = new eventReceiverClient(hostname.c_str());
+  m_Thread = std::thread(&GL1Service::Run, this);
+}
+
+GL1Service::~GL1Service()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_Cond.notify_all();
+  m_Thread.join();
+  delete erc;
+}
+
+int GL1Service::getGL1Data(const int evtnr, GL1Data &data)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (evtnr != m_Wanted || evtnr == m_Failed)
+  {
+    m_Wanted = evtnr;
+    m_Requests.push_back(evtnr);
+    if (m_Requests.size() > NREQUESTS)
+    {
+      m_Requests.pop_front();
+    }
+    m_Failed = -1;  // asked again, maybe the event server has it now
+    m_PrefetchStalled = -1;
+    m_Cond.notify_all();
+  }
+  auto iter = m_Cache.find(evtnr);
+  if (iter != m_Cache.end())
+  {
+    m_Hits++;
+  }
+  else
+  {
+    m_Misses++;
+    unsigned int generation = m_Generation;
+    m_Cond.wait(lock, [this, evtnr, generation]
+                { return m_Stop || m_Failed == evtnr || generation != m_Generation || m_Cache.find(evtnr) != m_Cache.end(); });
+    iter = m_Cache.find(evtnr);
+    if (iter == m_Cache.end())
+    {
+      data = GL1Data();
+      data.evtnr = evtnr;
+      return -1;
+    }
+  }
+  data = iter->second;
+  return (data.havepacket) ? 0 : -1;
+}
+
+void GL1Service::Reset()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Cache.clear();
+  m_Requests.clear();
+  m_Wanted = -1;
+  m_Failed = -1;
+  m_PrefetchStalled = -1;
+  m_Generation++;
+  m_Cond.notify_all();
+}
+
+// the requested event comes first, then the look-ahead in order
+int GL1Service::nextToFetch() const
+{
+  if (m_Wanted < 0 || m_Wanted == m_Failed)
+  {
+    return -1;
+  }
+  if (m_Cache.find(m_Wanted) == m_Cache.end())
+  {
+    return m_Wanted;
+  }
+  // up to the look-ahead of the highest request, the others are below
+  int last = *std::max_element(m_Requests.begin(), m_Requests.end()) + m_LookAhead;
+  for (int n = m_Wanted + 1; n <= last; n++)
+  {
+    if (n == m_PrefetchStalled)
+    {
+      return -1;
+    }
+    if (m_Cache.find(n) == m_Cache.end())
+    {
+      return n;
+    }
+  }
+  return -1;
+}
+
+// keep what any of the recent requests may ask for next
+void GL1Service::trimCache()
+{
+  if (m_Requests.empty())
+  {
+    return;
+  }
+  auto range = std::minmax_element(m_Requests.begin(), m_Requests.end());
+  while (!m_Cache.empty() && m_Cache.begin()->first < *range.first - m_KeepBehind)
+  {
+    m_Cache.erase(m_Cache.begin());
+  }
+  while (!m_Cache.empty() && m_Cache.rbegin()->first > *range.second + m_LookAhead)
+  {
+    m_Cache.erase(std::prev(m_Cache.end()));
+  }
+}
+
+void GL1Service::Run()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (!m_Stop)
+  {
+    int next = nextToFetch();
+    if (next < 0)
+    {
+      m_Cond.wait(lock);
+      continue;
+    }
+    // the network round trip happens without the lock
+    unsigned int generation = m_Generation;
+    lock.unlock();
+    GL1Data data;
+    fetch(next, data);
+    lock.lock();
+    if (generation != m_Generation)
+    {
+      continue;  // fetched for the previous run
+    }
+    if (data.haveevent)
+    {
+      m_Cache[next] = data;
+      trimCache();
+    }
+    else if (next == m_Wanted)
+    {
+      // not cached, the next request for it asks the event server again
+      m_Failed = next;
+    }
+    else
+    {
+      // the event server is not there yet, retry with the next request
+      m_PrefetchStalled = next;
+    }
+    m_Cond.notify_all();
+  }
+}
+
+int GL1Service::fetch(const int evtnr, GL1Data &data)
+{
+  data.evtnr = evtnr;
+  Event *gl1Event = erc->getEvent(evtnr);
+  if (!gl1Event)
+  {
+    if (verbosity)
+    {
+      std::cout << "GL1Service: no GL1 event " << evtnr << " from " << _hostname << std::endl;
+    }
+    return -1;
+  }
+  data.haveevent = true;
+  Packet *p = gl1Event->getPacket(14001);
+  if (!p)
+  {
+    delete gl1Event;
+    return -1;
+  }
+  data.havepacket = true;
+  data.bco = p->lValue(0, "BCO");
+  data.triggervector = static_cast<uint64_t>(p->lValue(0, "TriggerVector"));
+  data.triggerinput = static_cast<uint64_t>(p->lValue(0, "TriggerInput"));
+  data.livevector = static_cast<uint64_t>(p->lValue(0, "LiveVector"));
+  data.scaledvector = static_cast<uint64_t>(p->lValue(0, "ScaledVector"));
+  data.bunchnumber = p->lValue(0, "BunchNumber");
+  for (int i = 0; i < 16; i++)
+  {
+    data.gl1pscaler[i] = p->lValue(i, 2);
+  }
+  delete p;
+  delete gl1Event;
+  return 0;
+}
@@ -0,0 +1,126 @@
+#ifndef __GL1SERVICE_H__
+#define __GL1SERVICE_H__
+
+/**
+Shared access to the GL1 information for all monitors of a server.
+
+Instead of every monitor owning an eventReceiverClient and asking the GL1
+event server for the current event (and decoding packet 14001) by itself,
+all monitors get the decoded GL1 information from one GL1Service per GL1
+host:
+
+\begin{verbatim}
+  GL1Data gl1;
+  if (GL1Service::instance("gl1daq")->getGL1Data(evt->getEvtSequence(), gl1) == 0)
+  {
+    uint64_t scaled = gl1.scaledvector;
+  }
+\end{verbatim}
+
+A background thread fetches the requested event and decodes packet 14001
+once into a GL1Data. Decoded events are kept in a bounded cache, so the
+monitors of a server asking for the same event are served from memory. If
+the requested event is not in the cache yet, getGL1Data waits for the
+background thread to fetch it, which is no slower than asking the event
+server directly. An event the GL1 event server does not have is not
+cached, the next request for it asks again.
+
+While nobody waits, the thread also fetches the events following the
+requested ones (setLookAhead(n), 8 by default, 0 turns it off), so the
+next event is usually decoded before the monitors ask for it. It stops at
+the first event the GL1 event server does not have yet (its newest one)
+and tries again with the next request; a request which comes in during a
+look-ahead fetch waits for at most that one round trip.
+
+Monitors ask for different event numbers of the same event (shifted
+sequence numbers, GL1Manager's event delta). The cache is kept around all
+recently requested events (the last NREQUESTS requests): KeepBehind
+events below the lowest, LookAhead events above the highest.
+
+Event numbers start over with every run, Reset() (called by the monitors
+in BeginRun) drops everything cached for the previous run.
+
+The eventReceiverClient is only ever used by the background thread.
+
+*/
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class eventReceiverClient;
+
+struct GL1Data
+{
+  int evtnr{-1};
+  bool haveevent{false};   // the GL1 event server had this event
+  bool havepacket{false};  // and it contained packet 14001, the rest is only valid then
+  long long bco{0};
+  uint64_t triggervector{0};
+  uint64_t triggerinput{0};
+  uint64_t livevector{0};
+  uint64_t scaledvector{0};
+  int bunchnumber{-1};
+  long long gl1pscaler[16]{};  // lValue(i, 2) for the 16 gl1p triggers
+};
+
+class GL1Service
+{
+ public:
+  static GL1Service *instance(const std::string & /*hostname*/ = "gl1daq");
+  ~GL1Service();
+
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit GL1Service(const GL1Service &) = delete;
+  GL1Service &operator=(const GL1Service &) = delete;
+
+  /// fills data for event evtnr, returns 0 if the event with packet 14001 was found, -1 otherwise
+  int getGL1Data(const int /*evtnr*/, GL1Data & /*data*/);
+  /// forget the cached events, to be called at the begin of a run
+  void Reset();
+
+  void setLookAhead(const int n) { m_LookAhead = n; }
+  void setKeepBehind(const int n) { m_KeepBehind = n; }
+  void setVerbosity(const int v) { verbosity = v; }
+
+  long long CacheHits() const { return m_Hits; }
+  long long CacheMisses() const { return m_Misses; }
+
+ protected:
+  explicit GL1Service(const std::string & /*hostname*/);
+
+  void Run();
+  int fetch(const int /*evtnr*/, GL1Data & /*data*/);
+  int nextToFetch() const;
+  void trimCache();
+
+  static const unsigned int NREQUESTS = 32;
+
+  static std::map<std::string, GL1Service *> services;
+  static std::mutex servicesMutex;
+
+  std::string _hostname;
+  eventReceiverClient *erc{nullptr};
+
+  std::thread m_Thread;
+  std::mutex m_Mutex;
+  std::condition_variable m_Cond;
+  std::map<int, GL1Data> m_Cache;
+  bool m_Stop{false};
+  int m_Wanted{-1};           // last event asked for by a monitor
+  std::deque<int> m_Requests;  // the last NREQUESTS events asked for
+  int m_PrefetchStalled{-1};  // look-ahead event the event server did not have yet
+  int m_Failed{-1};           // requested event the event server did not have
+  unsigned int m_Generation{0};  // incremented by Reset(), fetches started before are dropped
+  int m_LookAhead{8};
+  int m_KeepBehind{64};
+  long long m_Hits{0};
+  long long m_Misses{0};
+  int verbosity{0};
+};
+
+#endif
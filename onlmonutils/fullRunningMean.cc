@@ -1,36 +1,28 @@
+
 #include "fullRunningMean.h"
 
+#include <algorithm>
+#include <cmath>
+
 fullRunningMean::fullRunningMean( const int n, const int d)
 {
-  int i,j;
-  depth = d;
+  depth = (d > 0) ? d : 1;
   NumberofChannels  = n;
-  current_depth =0;
-  array = new double *[NumberofChannels];
-  for (i=0; i< NumberofChannels; i++) 
-    {
-      array[i] = new double[depth];
-      for (j=0; j< depth; j++) array[i][j] = 0.;
-    }
+  current_depth = 0;
+  head = 0;
+  array.assign(static_cast<size_t>(NumberofChannels) * depth, 0.);
+  sum.assign(NumberofChannels, 0.);
+  sum2.assign(NumberofChannels, 0.);
 }
 
-fullRunningMean::~fullRunningMean()
-{
-  int i;
-  for (i=0; i< NumberofChannels; i++) 
-    {
-      delete [] array[i];
-    }
-  delete [] array;
-}
+fullRunningMean::~fullRunningMean() = default;
 
 int fullRunningMean::Add (const int iarr[])
 {
   int i;
 
   for (i = 0; i<NumberofChannels; i++) addChannel(i, double(iarr[i]) );
-  if ( current_depth < depth) current_depth++;
-  return 0;
+  return advance();
 						  
 }
 int fullRunningMean::Add (const float farr[])
@@ -38,8 +30,7 @@ int fullRunningMean::Add (const float farr[])
   int i;
 
   for (i = 0; i<NumberofChannels; i++) addChannel(i, farr[i]);
-  if ( current_depth < depth) current_depth++;
-  return 0;
+  return advance();
 						  
 }
 int fullRunningMean::Add (const double darr[])
@@ -47,45 +38,82 @@ int fullRunningMean::Add (const double darr[])
   int i;
 
   for (i = 0; i<NumberofChannels; i++) addChannel(i, darr[i]);
-  if ( current_depth < depth) current_depth++;
-  return 0;
+  return advance();
 }
 
 
 int fullRunningMean::Reset()
 {
-  int i,j;
-  for (i=0; i< NumberofChannels; i++) 
-    {
-      for (j=0; j< depth; j++) array[i][j] = 0.;
-    }
+  std::fill(array.begin(), array.end(), 0.);
+  std::fill(sum.begin(), sum.end(), 0.);
+  std::fill(sum2.begin(), sum2.end(), 0.);
+  current_depth = 0;
+  head = 0;
   return 0;
 }
 
 double fullRunningMean::getMean(const int ich) const
 {
-  int j;
-  double x = 0.;
+  if (current_depth == 0) return 0.;
+  return  sum[ich] / double(current_depth);
+}
 
+double fullRunningMean::getVariance(const int ich) const
+{
   if (current_depth == 0) return 0.;
+  double m = sum[ich] / double(current_depth);
+  double v = sum2[ich] / double(current_depth) - m * m;
+  // round-off can make this slightly negative for constant inputs
+  return (v > 0.) ? v : 0.;
+}
 
-  for (j=0; j<current_depth; j++) x += array[ich][j];
-  return  x / double(current_depth);
+double fullRunningMean::getRMS(const int ich) const
+{
+  return std::sqrt(getVariance(ich));
 }
 
 
 int fullRunningMean::addChannel(const int channel, const double k)
 {
-  int j;
-  if ( current_depth < depth)
+  double &slot = array[static_cast<size_t>(head) * NumberofChannels + channel];
+  if ( current_depth == depth)
     {
-       array[channel][current_depth] = k;
+      // the buffer is full, the slot holds the oldest entry, which drops out
+      sum[channel] -= slot;
+      sum2[channel] -= slot * slot;
     }
-  else
+  slot = k;
+  sum[channel] += k;
+  sum2[channel] += k * k;
+  return 0;
+}
+
+int fullRunningMean::advance()
+{
+  if ( current_depth < depth) current_depth++;
+  head++;
+  if ( head == depth)
     {
-      for (j=1; j<depth; j++) array[channel][j-1] = array[channel][j];
-      array[channel][depth-1] = k;
+      head = 0;
+      // once per turn around the buffer, get rid of the accumulated round-off
+      recalculateSums();
     }
   return 0;
 }
 
+int fullRunningMean::recalculateSums()
+{
+  int i,j;
+  std::fill(sum.begin(), sum.end(), 0.);
+  std::fill(sum2.begin(), sum2.end(), 0.);
+  for (j=0; j< current_depth; j++)
+    {
+      const double *row = &array[static_cast<size_t>(j) * NumberofChannels];
+      for (i=0; i< NumberofChannels; i++)
+	{
+	  sum[i] += row[i];
+	  sum2[i] += row[i] * row[i];
+	}
+    }
+  return 0;
+}
@@ -15,6 +15,14 @@ be off by a few percent.
 Since you will need to store the d most recent entries to the running
 mean this can lead to excessive amount of memory allocated.
 
+The d most recent entries of all channels are kept in one contiguous 
+circular buffer (d rows of NumberofChannels values). Adding a new reading 
+overwrites the oldest row and updates a per-channel running sum (and sum of 
+squares), so both Add and getMean cost O(1) per channel regardless of the 
+depth. To keep the floating point round-off of the incremental sums from 
+accumulating, the sums are recomputed from the buffer each time the 
+buffer wraps around, which is amortized O(1) per reading.  
+
 
 This class is mean to monitor lots of  values (such as all channels of a given
 detector) simultaneously; In the constructor you specify the "width" (how many channels) 
@@ -63,6 +71,7 @@ pm->getmean(i);
 
 #include "runningMean.h"
 
+#include <vector>
 
 class fullRunningMean : public runningMean {
 
@@ -77,6 +86,15 @@ public:
   /// the getMean(i) funtion returns the current mean value of channel i 
   double getMean(const int /*ich*/) const override;
 
+  /// the variance of the current entries of channel i 
+  double getVariance(const int /*ich*/) const;
+
+  /// the RMS (standard deviation) of the current entries of channel i 
+  double getRMS(const int /*ich*/) const;
+
+  /// the number of entries currently contributing to the mean (at most the depth)
+  int getCurrentDepth() const {return current_depth;};
+
   /// Reset will reset th whole class
   int Reset() override;
 
@@ -91,9 +109,16 @@ public:
 protected:
 
   int addChannel(const int /*channel*/, const double /*x*/);
+  int advance();
+  int recalculateSums();
+
   int depth;
   int current_depth;
-  double ** array;
+  int head;  // the row of the circular buffer the next reading goes to
+
+  std::vector<double> array;  // depth x NumberofChannels, row-major
+  std::vector<double> sum;
+  std::vector<double> sum2;
 
 };
 #endif
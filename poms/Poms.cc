@@ -27,6 +27,7 @@
 #include <TCanvas.h>
 #include <TGButton.h>
 #include <TGClient.h>  // for TGClient, gClient
+#include <TGLabel.h>
 #include <TGLayout.h>  // for TGLayoutHints, kLHintsTop, kLHintsE...
 #include <TGMenu.h>
 #include <TGMsgBox.h>
@@ -35,12 +36,18 @@
 #include <TROOT.h>
 #include <TSeqCollection.h>      // for TSeqCollection
 #include <TString.h>             // for TString
+#include <TTimer.h>
 #include <WidgetMessageTypes.h>  // for GET_MSG, GET_SUBMSG, kCM_BUTTON
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>  // for strlen
+#include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 const int SUBSYSTEM_ACTION_ID_BEGIN = 10001;
 //const ULong_t SHUTTER_ITEM_BG_COLOR = 0xffaacc;  // color is rrggbb (red, green, blue in hex)
@@ -51,6 +58,32 @@ const char* pomsFileTypes[] =
         "All files", "*",
         nullptr, nullptr};
 
+namespace
+{
+  // canvas name of a draw command, bbcDraw("FIRST") -> FIRST
+  std::string drawWhat(const std::string& cmd)
+  {
+    std::string::size_type begin = cmd.find('"');
+    std::string::size_type end = cmd.rfind('"');
+    if (begin == std::string::npos || end <= begin)
+    {
+      return "ALL";
+    }
+    return cmd.substr(begin + 1, end - begin - 1);
+  }
+
+  void deleteAllCanvases()
+  {
+    TSeqCollection* allCanvases = gROOT->GetListOfCanvases();
+    TCanvas* canvas = nullptr;
+    while ((canvas = (TCanvas*) allCanvases->First()))
+    {
+      std::cout << "Deleting Canvas " << canvas->GetName() << std::endl;
+      delete canvas;
+    }
+  }
+}  // namespace
+
 /////////////////////////////////////////////////////////////////////////////
 // PomsMainFrame Implementation                                            //
 /////////////////////////////////////////////////////////////////////////////
@@ -122,6 +155,9 @@ PomsMainFrame::PomsMainFrame(const TGWindow* p, UInt_t w, UInt_t h)
   // Standard Window Setup functions
   SetWindowName("POMS: PHENIX Online Monitoring System");
   _shutter = nullptr;
+
+  // the histograms are fetched in worker threads
+  ROOT::EnableThreadSafety();
 }
 
 void PomsMainFrame::SetMacroPath(const char* path)
@@ -156,6 +192,12 @@ void PomsMainFrame::Draw()
   ysize -= 100;
   cl->SetDisplaySizeX(xsize);
   cl->SetDisplaySizeY(ysize);
+
+  if (!_pollTimer)
+  {
+    _pollTimer = new TTimer(this, 200);  // synchronous, runs in the gui event loop
+    _pollTimer->TurnOn();
+  }
 }
 
 PomsMainFrame::~PomsMainFrame()
@@ -167,8 +209,7 @@ PomsMainFrame::~PomsMainFrame()
   delete _menuFile;
   delete _shutter;
   delete _menuWindow;
-
-  //TODO:  Add code to clean up threads
+  delete _pollTimer;
 
   _instance = nullptr;
 }
@@ -246,6 +287,22 @@ Bool_t PomsMainFrame::ProcessMessage(Long_t msg, Long_t parm1, Long_t /* parm2 *
   return kTRUE;
 }
 
+Bool_t PomsMainFrame::HandleTimer(TTimer* /* timer */)
+{
+  // drawing can process gui events, do not start the next draw from inside
+  if (_polling)
+  {
+    return kTRUE;
+  }
+  _polling = true;
+  for (auto subSystem : _subSystemList)
+  {
+    subSystem->Poll();
+  }
+  _polling = false;
+  return kTRUE;
+}
+
 int PomsMainFrame::HandleButtonPoms(Long_t parm1)
 {
   // Check to see if button belongs to SubSystemAction
@@ -337,6 +394,9 @@ TGShutter* PomsMainFrame::BuildShutter()
         container->AddFrame(button, layout);
         button->Associate(this);
       }
+      TGLabel* status = new TGLabel(container, "idle");
+      container->AddFrame(status, layout);
+      (*subSystem)->SetStatusLabel(status);
       shutter->AddItem(shutterItem);
     }
   }
@@ -438,6 +498,8 @@ SubSystem::SubSystem(const char* name, const char* prefix, int loadLibrary)
     const char* error = "ERROR: name and prefix must not be null!";
     throw error;
   }
+  _drawer = _prefix + "MONDRAW";
+  std::transform(_drawer.begin(), _drawer.end(), _drawer.begin(), ::toupper);
 
   if (loadLibrary)
   {
@@ -450,6 +512,17 @@ SubSystem::SubSystem(const char* name, const char* prefix, int loadLibrary)
 
 SubSystem::~SubSystem()
 {
+  if (_fetchThread.joinable())
+  {
+    _fetchThread.join();
+  }
+  for (auto& transfer : _transfers)
+  {
+    for (auto& recv : transfer.received)
+    {
+      delete recv.second;
+    }
+  }
   delete _canvasList;
 }
 
@@ -595,6 +668,140 @@ void SubSystem::CascadeCanvases()
   ShowCanvases();
 }
 
+int SubSystem::FetchAndDraw(SubSystemAction* action, int refresh)
+{
+  _pendingAction = action;
+  _pendingRefresh = refresh;
+  if (_fetchThread.joinable())
+  {
+    return 0;  // drawn when the running fetch is done
+  }
+  if (!_initialized)  // Check to see if DrawInit() has been executed
+  {
+    gROOT->ProcessLine((_prefix + "DrawInit(1)").c_str());
+    _initialized = 1;
+  }
+  _transfers.clear();
+  if (OnlMonClient::instance()->PrepareTransfer(_drawer, _transfers, drawWhat(action->GetCmd())))
+  {
+    // servers not located yet, the draw macro searches for them (blocking)
+    SetStatus("searching servers");
+    DrawPending(0);
+    return 0;
+  }
+  _nRequested = 0;
+  for (auto& transfer : _transfers)
+  {
+    _nRequested += transfer.hnames.size();
+  }
+  _fetchAction = action;
+  _nReceived = 0;
+  _fetchDone = false;
+  _fetchStart = std::chrono::steady_clock::now();
+  _fetchThread = std::thread(&SubSystem::FetchWorker, this);
+  return 0;
+}
+
+void SubSystem::FetchWorker()
+{
+  for (auto& transfer : _transfers)
+  {
+    OnlMonClient::TransferHistos(transfer, _fetchTimeout * 1000, &_nReceived);
+  }
+  _fetchDone = true;
+}
+
+void SubSystem::Poll()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (_fetchThread.joinable())
+  {
+    double seconds = std::chrono::duration<double>(now - _fetchStart).count();
+    if (!_fetchDone)
+    {
+      std::ostringstream status;
+      status << std::fixed << std::setprecision(1);
+      if (seconds > _fetchTimeout)
+      {
+        status << "no answer since " << seconds << " s";
+      }
+      else
+      {
+        status << "fetching " << _nReceived << "/" << _nRequested << " (" << seconds << " s)";
+      }
+      SetStatus(status.str());
+      return;
+    }
+    _fetchThread.join();
+    OnlMonClient* cl = OnlMonClient::instance();
+    int iret = 0;
+    for (auto& transfer : _transfers)
+    {
+      iret = std::min(iret, cl->ReceiveTransfer(transfer));
+    }
+    _transfers.clear();
+    if (_pendingAction && _pendingAction != _fetchAction)
+    {
+      // another page was asked for in the meantime, it may need other histograms
+      FetchAndDraw(_pendingAction, _pendingRefresh);
+      return;
+    }
+    if (iret == -1)
+    {
+      // a server went away, the draw macro looks for it again (blocking)
+      SetStatus("server lost, searching");
+      DrawPending(0);
+      return;
+    }
+    DrawPending(1);
+    time_t drawtime = time(nullptr);
+    std::ostringstream status;
+    status << ((iret == -2) ? "timeout " : "updated ")
+           << std::put_time(localtime(&drawtime), "%H:%M:%S")
+           << std::fixed << std::setprecision(1) << " (" << seconds << " s)";
+    SetStatus(status.str());
+    return;
+  }
+  if (_refreshInterval > 0 && _lastDrawAction && now - _lastDraw >= std::chrono::seconds(_refreshInterval))
+  {
+    if (!GetCanvases(1))
+    {
+      _lastDrawAction = nullptr;  // the shifter closed the page, stop refreshing it
+      return;
+    }
+    FetchAndDraw(_lastDrawAction, 1);
+  }
+}
+
+void SubSystem::DrawPending(int cacheOnly)
+{
+  SubSystemAction* action = _pendingAction;
+  _pendingAction = nullptr;
+  if (!action)
+  {
+    return;
+  }
+  // a refresh redraws into the open canvases
+  if (!_pendingRefresh)
+  {
+    deleteAllCanvases();
+  }
+  OnlMonClient* cl = OnlMonClient::instance();
+  cl->CacheOnly(cacheOnly);
+  action->Draw();
+  cl->CacheOnly(false);
+  _lastDrawAction = action;
+  _lastDraw = std::chrono::steady_clock::now();
+}
+
+void SubSystem::SetStatus(const std::string& status)
+{
+  if (_statusLabel)
+  {
+    _statusLabel->SetText(status.c_str());
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //   SubSystemAction Implementation                                        //
 /////////////////////////////////////////////////////////////////////////////
@@ -653,24 +860,16 @@ SubSystemAction::~SubSystemAction()
 }
 
 int SubSystemAction::Execute()
+{
+  return _parent->FetchAndDraw(this);
+}
+
+int SubSystemAction::Draw()
 {
   if (_running)
     return 0;
 
   _running = true;
-  if (!_parent->isInitialized())  // Check to see if DrawInit() has been executed
-  {
-    gROOT->ProcessLine((_parent->GetPrefix() + "DrawInit(1)").c_str());
-    _parent->setInitialized(1);
-  }
-
-  TSeqCollection* allCanvases = gROOT->GetListOfCanvases();
-  TCanvas* canvas = nullptr;
-  while ((canvas = (TCanvas*) allCanvases->First()))
-  {
-    std::cout << "Deleting Canvas " << canvas->GetName() << std::endl;
-    delete canvas;
-  }
   gROOT->ProcessLine(_cmd.c_str());
   _running = false;
   return 0;
@@ -685,26 +884,12 @@ SubSystemActionDraw::SubSystemActionDraw(SubSystem* parent)
 {
 }
 
-int SubSystemActionDraw::Execute()
+int SubSystemActionDraw::Draw()
 {
   if (_running)
     return 0;
 
   _running = true;
-
-  if (!_parent->isInitialized())  // Check to see if DrawInit() has been executed
-  {
-    gROOT->ProcessLine((_parent->GetPrefix() + "DrawInit(1)").c_str());
-    _parent->setInitialized(1);
-  }
-
-  TSeqCollection* allCanvases = gROOT->GetListOfCanvases();
-  TCanvas* canvas = nullptr;
-  while ((canvas = (TCanvas*) allCanvases->First()))
-  {
-    std::cout << "Deleting Canvas " << canvas->GetName() << std::endl;
-    delete canvas;
-  }
   gROOT->ProcessLine((_parent->GetPrefix() + "Draw()").c_str());
   _running = false;
   return 0;
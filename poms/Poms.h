@@ -28,11 +28,17 @@
 #include <TGShutter.h>
 #pragma GCC diagnostic pop
 
+#include <onlmon/OnlMonClient.h>
+
 /* Standard C++ headers */
 
+#include <atomic>
+#include <chrono>
 #include <list>
 #include <map>
 #include <string>
+#include <thread>
+#include <vector>
 
 /* forward declarations to speed up compilation */
 class TList;
@@ -40,7 +46,9 @@ class TGMenuBar;
 class TGButton;
 class TGPopupMenu;
 class TGHotString;
+class TGLabel;
 class TGWindow;
+class TTimer;
 
 #define POMS_VER "POMS Ver 1.0: "
 
@@ -98,6 +106,9 @@ class PomsMainFrame : public TGMainFrame
 
   TGButton* startloop;
   TGButton* stoploop;
+  // polls the background fetches of the subsystems (gui thread)
+  TTimer* _pollTimer{nullptr};
+  bool _polling{false};
   //Collections
   SubSystemList _subSystemList;
 
@@ -117,6 +128,7 @@ class PomsMainFrame : public TGMainFrame
   void SetMacroPath(const char* path);
   virtual void CloseWindow();
   virtual Bool_t ProcessMessage(Long_t msg, Long_t parm1, Long_t /* parm2 */);
+  virtual Bool_t HandleTimer(TTimer* timer);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Woverloaded-virtual"
   void Draw();
@@ -139,6 +151,12 @@ class PomsMainFrame : public TGMainFrame
 
 /////////////////////////////////////////////////////////////////////////////
 //    Class to store information on each subsystem that is registered      //
+//                                                                         //
+//    Draw actions do not fetch the histograms in the gui thread: a        //
+//    worker thread downloads them, PomsMainFrame polls the subsystems     //
+//    and the draw macro runs in the gui thread (answered from the client  //
+//    cache) once everything arrived. The status label in the shutter      //
+//    shows the progress.                                                  //
 /////////////////////////////////////////////////////////////////////////////
 
 class SubSystem
@@ -146,14 +164,39 @@ class SubSystem
  private:
   std::string _name;
   std::string _prefix;
+  std::string _drawer;
   TList* _canvasList;
   SubSystemActionList _actions;
   int _initialized;
 
+  // background fetch
+  TGLabel* _statusLabel{nullptr};
+  SubSystemAction* _pendingAction{nullptr};
+  SubSystemAction* _fetchAction{nullptr};
+  SubSystemAction* _lastDrawAction{nullptr};
+  int _pendingRefresh{0};
+  int _refreshInterval{0};
+  int _fetchTimeout{30};
+  int _nRequested{0};
+  std::atomic<int> _nReceived{0};
+  std::atomic<bool> _fetchDone{false};
+  std::thread _fetchThread;
+  std::vector<OnlMonClient::HistoTransfer> _transfers;
+  std::chrono::steady_clock::time_point _fetchStart;
+  std::chrono::steady_clock::time_point _lastDraw;
+
+  void FetchWorker();
+  void DrawPending(int cacheOnly);
+  void SetStatus(const std::string& status);
+
  public:
   SubSystem(const char* name, const char* prefix, int loadLibrary = 1);
   virtual ~SubSystem();
 
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit SubSystem(const SubSystem&) = delete;
+  SubSystem& operator=(const SubSystem&) = delete;
+
   // Public Functions
   TList* GetCanvases(int forceReQuery = 0);
   void PrintCanvasList();
@@ -167,7 +210,17 @@ class SubSystem
   void TileCanvases();
   void CascadeCanvases();
 
+  // starts the fetch, the action is drawn when Poll() finds it finished
+  // (refresh != 0 redraws into the open canvases)
+  int FetchAndDraw(SubSystemAction* action, int refresh = 0);
+  // gui thread, called by PomsMainFrame::HandleTimer()
+  void Poll();
+
   // Accessor Methods
+  void SetDrawer(const std::string& name) { _drawer = name; }  // default <PREFIX>MONDRAW
+  void SetRefreshInterval(const int seconds) { _refreshInterval = seconds; }  // redraw the last page, 0 is off
+  void SetFetchTimeout(const int seconds) { _fetchTimeout = seconds; }
+  void SetStatusLabel(TGLabel* label) { _statusLabel = label; }
   const std::string& GetName() { return _name; };
   const std::string& GetPrefix() { return _prefix; };
   SubSystemActionList* GetActions() { return &_actions; };
@@ -200,7 +253,10 @@ class SubSystemAction
   SubSystemAction(SubSystem* parent, const char* cmd, const char* description);
   virtual ~SubSystemAction();
 
+  // fetches in the background and draws when done (see SubSystem)
   virtual int Execute();
+  // runs the draw command, gui thread
+  virtual int Draw();
 
   // Accessor Methods
   const std::string& GetCmd() { return _cmd; };
@@ -214,7 +270,7 @@ class SubSystemActionDraw : public SubSystemAction
  public:
   SubSystemActionDraw(SubSystem* parent);
   virtual ~SubSystemActionDraw(){};
-  int Execute();
+  int Draw();
 };
 
 class SubSystemActionSavePlot : public SubSystemAction
@@ -4,18 +4,63 @@ use strict;
 use warnings;
 
 sub findruns;
+sub process_subsystem;
 
 my $stopthis = sprintf("stopthis");
 my $histodir = sprintf("/sphenix/lustre01/sphnxpro/commissioning/online_monitoring/histograms");
 my @subsystems = ("BBCMON", "CEMCMON", "DAQMON", "IHCALMON", "INTTMON", "LL1MON", "LOCALPOLMON", "MVTXMON", "OHCALMON", "SPINMON", "SEPDMON", "TPCMON", "TPOTMON", "ZDCMON");
 #my @subsystems = ("BBCMON", "CEMCMON", "INTTMON", "LL1MON", "TPOTMON", "TPCMON");
 
+# number of subsystems processed in parallel, each one in its own root.exe
+# (own ROOT state), the html menu files they share are locked by OnlMonHtml
+my $maxjobs = 4;
+if (exists $ENV{ONLMON_HTML_JOBS})
+{
+    $maxjobs = int($ENV{ONLMON_HTML_JOBS});
+}
+if ($maxjobs < 1)
+{
+    $maxjobs = 1;
+}
+
+my %jobs = ();
 for my $subsys (@subsystems)
 {
     if (-e $stopthis)
     {
 	last;
     }
+    while (keys %jobs >= $maxjobs)
+    {
+	my $pid = wait();
+	last if ($pid < 0);
+	delete $jobs{$pid};
+    }
+    my $pid = fork();
+    if (! defined $pid)
+    {
+	print "could not fork for $subsys, running it here\n";
+	process_subsystem($subsys);
+	next;
+    }
+    if ($pid == 0)
+    {
+	process_subsystem($subsys);
+	exit(0);
+    }
+    $jobs{$pid} = $subsys;
+}
+while (keys %jobs > 0)
+{
+    my $pid = wait();
+    last if ($pid < 0);
+    delete $jobs{$pid};
+}
+unlink $stopthis;
+
+sub process_subsystem
+{
+    my $subsys = shift;
     my %donehash = ();
     my $rundone = sprintf("%s.done",$subsys);
     if (-f $rundone)
@@ -62,7 +107,6 @@ for my $subsys (@subsystems)
 	my $updatedone = sprintf("echo %d >> %s",$run,$rundone);
 	system($updatedone);
     }
-    unlink $stopthis;
 }
 
 sub findruns
@@ -4,8 +4,10 @@
 // (more info - check the difference in include path search when using "" versus <>)
 
 #include "BbcMon.h"
+#include "BbcVtxPublisher.h"
 #include <mbd/MbdEvent.h>
 
+#include <onlmon/GL1Service.h>
 #include <onlmon/OnlMon.h>
 #include <onlmon/OnlMonDB.h>
 #include <onlmon/OnlMonServer.h>
@@ -16,14 +18,12 @@
 #include <Event/Event.h>
 #include <Event/EventTypes.h>
 #include <Event/packet.h>
-#include <Event/eventReceiverClient.h>
 
 #include <mbd/MbdGeomV1.h>
 #include <mbd/MbdOutV2.h>
 #include <mbd/MbdPmtContainerV1.h>
 #include <mbd/MbdPmtHit.h>
 
-#include <TF1.h>
 #include <TGraphErrors.h>
 #include <TH1.h>
 #include <TH2.h>
@@ -31,6 +31,7 @@
 #include <TString.h>
 #include <TSystem.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>  // for printf
 #include <fstream>
@@ -59,7 +60,7 @@ BbcMon::~BbcMon()
 {
   delete bevt;
   delete _mbdgeom;
-  delete erc;
+  delete vtxpublisher;
 
   return;
 }
@@ -156,13 +157,13 @@ int BbcMon::Init()
   // get gl1 event receiver
   if ( useGL1==1 )
   {
-    erc = new eventReceiverClient("gl1daq");
+    gl1service = GL1Service::instance("gl1daq");
     rdb = new RunDBodbc;
   }
   else if ( useGL1==2 )
   {
     std::cout << "Connecting to eventserver on localhost" << std::endl;
-    erc = new eventReceiverClient("localhost");
+    gl1service = GL1Service::instance("localhost");
     rdb = new RunDBodbc;
   }
 
@@ -389,7 +390,6 @@ int BbcMon::Init()
   bbc_zvertex_hcalmbd->GetXaxis()->SetLabelSize(0.07);
   bbc_zvertex_hcalmbd->GetXaxis()->SetTickSize(0.1);
 
-  f_zvtx = new TF1("f_zvtx", "gaus", -30., 30.);
   bbc_nevent_counter = new TH1F("bbc_nevent_counter",
                                 "The nEvent Counter bin1:Total Event bin2:Collision Event bin3:Laser Event",
                                 16, 0, 16);
@@ -604,6 +604,10 @@ int BbcMon::Init()
   {
     UpdateSendFlag( 0 );
   }
+  if ( vtxpublisher == nullptr )
+  {
+    vtxpublisher = new BbcVtxPublisher( new BbcVtxHttpSink() );
+  }
 
   gl1badflagfname = "/home/phnxrc/operations/mbd/mbdgl1bypass.";
   gl1badflagfname += hname;
@@ -618,6 +622,10 @@ int BbcMon::BeginRun(const int runno)
   // this is the place to do it
   std::cout << "BbcMon::BeginRun(), run " << runno << std::endl;
   Reset();
+  if ( gl1service )
+  {
+    gl1service->Reset();  // the gl1 events of the previous run are gone
+  }
   if ( useGL1 )
   {
     OnlMonServer *se = OnlMonServer::instance();
@@ -700,6 +708,65 @@ uint64_t BbcMon::GetMinBiasTrigBit(uint64_t trigs_enabled)
   return std::numeric_limits<uint64_t>::max();
 }
 
+// Gaussian mean and width of the vertex peak from truncated moments of the
+// histogram, much cheaper than a fit. The first pass takes the moments within
+// +-75 cm, the next ones within +-2.5 sigma around the mean, with the width
+// corrected for the truncated gaussian tails.
+int BbcMon::CalcZVertex(const TH1 *h, double &mean, double &rms)
+{
+  static const double nsigma = 2.5;
+  static const double trunc_corr = std::sqrt(1. - 2. * nsigma * std::exp(-0.5 * nsigma * nsigma) / std::sqrt(2. * M_PI) / std::erf(nsigma / std::sqrt(2.)));
+
+  double lo = -75.;
+  double hi = 75.;
+  for (int iter = 0; iter < 3; iter++)
+  {
+    double sumw = 0.;
+    double sumx = 0.;
+    double sumxx = 0.;
+    int blo = h->GetXaxis()->FindFixBin(lo);
+    int bhi = h->GetXaxis()->FindFixBin(hi);
+    for (int ib = std::max(blo, 1); ib <= std::min(bhi, h->GetNbinsX()); ib++)
+    {
+      double w = h->GetBinContent(ib);
+      double x = h->GetBinCenter(ib);
+      sumw += w;
+      sumx += w * x;
+      sumxx += w * x * x;
+    }
+    if ( sumw <= 0. )
+    {
+      return -1;
+    }
+    mean = sumx / sumw;
+    double var = sumxx / sumw - mean * mean;
+    if ( var <= 0. )
+    {
+      return -1;
+    }
+    rms = std::sqrt(var);
+    if ( iter > 0 )
+    {
+      rms /= trunc_corr;
+    }
+    lo = mean - nsigma * rms;
+    hi = mean + nsigma * rms;
+  }
+  return 0;
+}
+
+void BbcMon::SetVtxSink(BbcVtxSink *sink)
+{
+  if ( vtxpublisher == nullptr )
+  {
+    vtxpublisher = new BbcVtxPublisher( sink );
+  }
+  else
+  {
+    vtxpublisher->SetSink( sink );
+  }
+}
+
 int BbcMon::UpdateSendFlag(const int flag)
 {
   sendflag = flag;
@@ -871,24 +938,24 @@ int BbcMon::process_event(Event *evt)
     trigraw = 0UL;
     triglive = 0UL;
     trigscaled = 0UL;
-    Event *gl1Event = erc->getEvent( f_evt );
-    //std::cout << "gl1event " << (uint64_t)gl1Event << "\t" << f_evt << std::endl;
+    GL1Data gl1;
+    gl1service->getGL1Data( f_evt, gl1 );
+    //std::cout << "gl1event " << gl1.haveevent << "\t" << f_evt << std::endl;
 
-    if (gl1Event)
+    if (gl1.haveevent)
     {      
         se->IncrementGl1FoundCounter();
         //std::cout << "Found gl1event " << f_evt << std::endl;
-        Packet* p_gl1 = gl1Event->getPacket(14001);
-        if (p_gl1)
+        if (gl1.havepacket)
         {
-            //gl1_bco = p_gl1->lValue(0,"BCO");
-            triggervec = static_cast<uint64_t>( p_gl1->lValue(0,"TriggerVector") );
-            triginput = static_cast<uint64_t>( p_gl1->lValue(0,"TriggerInput") );
+            //gl1_bco = gl1.bco;
+            triggervec = gl1.triggervector;
+            triginput = gl1.triggerinput;
             //std::cout << "trig " << std::hex << triggervec << "\t" << triginput << std::dec << std::endl;
 
-            trigraw = static_cast<uint64_t>( p_gl1->lValue(0,"TriggerInput") );
-            triglive = static_cast<uint64_t>( p_gl1->lValue(0,"LiveVector") );
-            trigscaled = static_cast<uint64_t>( p_gl1->lValue(0,"ScaledVector") );
+            trigraw = gl1.triggerinput;
+            triglive = gl1.livevector;
+            trigscaled = gl1.scaledvector;
 
             triggervec = trigscaled;
 
@@ -911,10 +978,7 @@ int BbcMon::process_event(Event *evt)
                     bbc_trigs->Fill( itrig );
                 }
             }
-
-            delete p_gl1;
         }
-        delete gl1Event;
     }
   }
   else
@@ -1051,42 +1115,21 @@ int BbcMon::process_event(Event *evt)
   //int n_goodevt = bbc_nevent_counter->GetBinContent(6);
   if ( bbc_zvertex_short->Integral() >= 200 )
   {
-      f_zvtx->SetRange(-75., 75.);
-      f_zvtx->SetParameters(250, 0., 10);
+      // Report z-vertex mean and width
+      double mean = 0.;
+      double rms = 0.;
+      if ( CalcZVertex( bbc_zvertex_short, mean, rms ) == 0 )
       {
-        bbc_zvertex_short->Fit(f_zvtx, "RNQ");
-
-        // Report z-vertex mean and width
-        Double_t mean = f_zvtx->GetParameter(1);
-        Double_t rms = f_zvtx->GetParameter(2);
-        // we should do a check of a good fit here (skip for now)
-
         std::ostringstream msg;
         msg << "MBD zvertex mean/width: " << mean << " " << rms;
         se->send_message(this, MSG_SOURCE_BBC, MSG_SEV_INFORMATIONAL, msg.str(), 1);
         std::cout << "MBD zvtx mean/width: " << mean << " " << rms << std::endl;
 
+        // the publisher sends from its own thread, this does not wait for it
         if ( useGL1==1 && GetSendFlag() == 1 )
         {
-          TString cmd = "/home/phnxrc/mbd/chiu/mbd_operations/httpRequestDemo.py -s sphenix.detector zMeanM "; cmd += mean;
-          cmd += "; /home/phnxrc/mbd/chiu/mbd_operations/httpRequestDemo.py -s sphenix.detector zRmsM "; cmd += rms;
-          gSystem->Exec( cmd );
-        }
-        else
-        {
-            // Set to 0 if we aren't sending
-            /*
-               TString retval = gSystem->GetFromPipe( "/home/phnxrc/mbd/chiu/mbd_operations/httpRequestDemo.py -g sphenix.detector zRmsM" );
-               std::cout << "retval " << retval << std::endl;
-               if ( retval != "0" )
-               {
-               TString cmd = "/home/phnxrc/mbd/chiu/mbd_operations/httpRequestDemo.py -s sphenix.detector zMeanM 0";
-               cmd += "; /home/phnxrc/mbd/chiu/mbd_operations/httpRequestDemo.py -s sphenix.detector zRmsM 0";
-               gSystem->Exec( cmd );
-               }
-               */
+          vtxpublisher->Publish( mean, rms );
         }
-
       }
       bbc_zvertex_short->Reset();
   }
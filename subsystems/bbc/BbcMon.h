@@ -9,15 +9,16 @@
 class Event;
 class TH1;
 class TH2;
-class TF1;
 class TH2Poly;
 class MbdEvent;
 class MbdGeom;
 class MbdOut;
 class MbdPmtContainer;
 //class GL1Manager;
-class eventReceiverClient;
+class GL1Service;
 class RunDBodbc;
+class BbcVtxPublisher;
+class BbcVtxSink;
 // class OnlMonDB;
 
 class BbcMon : public OnlMon
@@ -34,6 +35,8 @@ class BbcMon : public OnlMon
 
   void set_GL1(const int g) { useGL1 = g; }
   void set_skipto(const int s) { skipto = s; }
+  // where the vertex mean/width goes, default is the http script (takes ownership)
+  void SetVtxSink(BbcVtxSink *sink);
 
  protected:
   int DBVarInit();
@@ -59,7 +62,7 @@ class BbcMon : public OnlMon
   uint64_t emcalmbd{0};       // all emcal triggers, with bbc
   uint64_t hcalmbd{0};        // all hcal triggers, with bbc
   uint64_t orig_trigmask{0};  // store for recovering from runs with one trigger defined
-  eventReceiverClient *erc{nullptr};
+  GL1Service *gl1service{nullptr};  // shared, not owned
   int      skipto{0};
   //GL1Manager *gl1mgr{nullptr};
   RunDBodbc *rdb{nullptr};
@@ -80,6 +83,8 @@ class BbcMon : public OnlMon
   int GetFillNumber();
   int GetSendFlag();
   int UpdateSendFlag(const int flag);
+  int CalcZVertex(const TH1 *h, double &mean, double &rms);
+  BbcVtxPublisher *vtxpublisher{nullptr};
 
   // kludge to work around situations when gl1 events are being received
   int gl1badflag{0};   // 0 = normal, 1 = gl1 bad, accept all events
@@ -117,7 +122,6 @@ class BbcMon : public OnlMon
   TH1 *bbc_zvertex_hcal{nullptr};   // HCAL triggers
   TH1 *bbc_zvertex_emcalmbd{nullptr};  // EMCAL triggers, w/ BBC
   TH1 *bbc_zvertex_hcalmbd{nullptr};   // HCAL triggers, w/ BBC
-  TF1 *f_zvtx{nullptr};             // Used for fitting central vertex peak
   // TH1 *bbc_zvertex_bbll1_novtx = nullptr;
   // TH1 *bbc_zvertex_bbll1_narrowvtx = nullptr;  // Run11 pp
 
@@ -0,0 +1,109 @@
+#include "BbcVtxPublisher.h"
+
+#include <cstdlib>  // for std::system
+#include <ctime>
+#include <iostream>
+#include <sstream>
+
+BbcVtxHttpSink::BbcVtxHttpSink(const std::string &script)
+  : m_Script(script)
+{
+}
+
+int BbcVtxHttpSink::Send(const double mean, const double rms)
+{
+  std::ostringstream cmd;
+  cmd << m_Script << " -s sphenix.detector zMeanM " << mean
+      << "; " << m_Script << " -s sphenix.detector zRmsM " << rms;
+  int iret = std::system(cmd.str().c_str());
+  if (iret != 0)
+  {
+    std::cout << "BbcVtxHttpSink: " << cmd.str() << " returned " << iret << std::endl;
+  }
+  return iret;
+}
+
+BbcVtxFileSink::BbcVtxFileSink(const std::string &fname)
+  : m_File(fname, std::ios::app)
+{
+  if (!m_File.is_open())
+  {
+    std::cout << "BbcVtxFileSink: unable to open file " << fname << std::endl;
+  }
+}
+
+int BbcVtxFileSink::Send(const double mean, const double rms)
+{
+  if (!m_File.is_open())
+  {
+    return -1;
+  }
+  m_File << std::time(nullptr) << " " << mean << " " << rms << std::endl;
+  return 0;
+}
+
+BbcVtxPublisher::BbcVtxPublisher(BbcVtxSink *sink)
+  : m_Sink(sink)
+{
+  m_Thread = std::thread(&BbcVtxPublisher::Run, this);
+}
+
+BbcVtxPublisher::~BbcVtxPublisher()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_Cond.notify_one();
+  m_Thread.join();
+  delete m_Sink;
+}
+
+void BbcVtxPublisher::SetSink(BbcVtxSink *sink)
+{
+  std::lock_guard<std::mutex> lock(m_SinkMutex);
+  delete m_Sink;
+  m_Sink = sink;
+}
+
+void BbcVtxPublisher::Publish(const double mean, const double rms)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Pending)
+    {
+      m_Dropped++;
+    }
+    m_Mean = mean;
+    m_Rms = rms;
+    m_Pending = true;
+  }
+  m_Cond.notify_one();
+}
+
+void BbcVtxPublisher::Run()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_Cond.wait(lock, [this] { return m_Pending || m_Stop; });
+    if (m_Stop)
+    {
+      return;
+    }
+    double mean = m_Mean;
+    double rms = m_Rms;
+    m_Pending = false;
+    // do not hold the lock while sending, Publish() must never wait for the sink
+    lock.unlock();
+    {
+      std::lock_guard<std::mutex> sinklock(m_SinkMutex);
+      if (m_Sink)
+      {
+        m_Sink->Send(mean, rms);
+        m_Sent++;
+      }
+    }
+    lock.lock();
+  }
+}
@@ -0,0 +1,77 @@
+#ifndef BBC_BBCVTXPUBLISHER_H
+#define BBC_BBCVTXPUBLISHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Destination of the MBD z-vertex mean/width. Send() is only ever called
+// from the publisher thread, so it may block (network, scripts, ...)
+class BbcVtxSink
+{
+ public:
+  virtual ~BbcVtxSink() = default;
+  virtual int Send(const double mean, const double rms) = 0;
+};
+
+// production sink: sets zMeanM/zRmsM with the httpRequestDemo.py script
+class BbcVtxHttpSink : public BbcVtxSink
+{
+ public:
+  explicit BbcVtxHttpSink(const std::string &script = "/home/phnxrc/mbd/chiu/mbd_operations/httpRequestDemo.py");
+  int Send(const double mean, const double rms) override;
+
+ private:
+  std::string m_Script;
+};
+
+// local sink for testing, appends "<time> <mean> <rms>" lines to a file
+class BbcVtxFileSink : public BbcVtxSink
+{
+ public:
+  explicit BbcVtxFileSink(const std::string &fname);
+  int Send(const double mean, const double rms) override;
+
+ private:
+  std::ofstream m_File;
+};
+
+// Hands vertex results to a background thread which forwards them to the sink,
+// so the event loop never waits for the publication. If the sink is slower
+// than the results come in, only the most recent result is sent.
+class BbcVtxPublisher
+{
+ public:
+  explicit BbcVtxPublisher(BbcVtxSink *sink = nullptr);  // takes ownership of the sink
+  ~BbcVtxPublisher();
+
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit BbcVtxPublisher(const BbcVtxPublisher &) = delete;
+  BbcVtxPublisher &operator=(const BbcVtxPublisher &) = delete;
+
+  void SetSink(BbcVtxSink *sink);  // takes ownership, deletes the previous sink
+  void Publish(const double mean, const double rms);  // does not block
+
+  int Sent() const { return m_Sent; }
+  int Dropped() const { return m_Dropped; }
+
+ private:
+  void Run();
+
+  BbcVtxSink *m_Sink{nullptr};
+  std::thread m_Thread;
+  std::mutex m_Mutex;      // protects the pending result
+  std::mutex m_SinkMutex;  // protects the sink
+  std::condition_variable m_Cond;
+  bool m_Pending{false};
+  bool m_Stop{false};
+  double m_Mean{0.};
+  double m_Rms{0.};
+  std::atomic<int> m_Sent{0};
+  std::atomic<int> m_Dropped{0};  // results overwritten before they could be sent
+};
+
+#endif /* BBC_BBCVTXPUBLISHER_H */
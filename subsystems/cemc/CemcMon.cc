@@ -6,6 +6,8 @@
 #include "CemcMon.h"
 
 #include <onlmon/OnlMon.h>  // for OnlMon
+#include <onlmon/CaloPacketDecoder.h>
+#include <onlmon/GL1Service.h>
 #include <onlmon/OnlMonServer.h>
 #include <onlmon/pseudoRunningMean.h>
 
@@ -16,7 +18,6 @@
 
 #include <Event/Event.h>
 #include <Event/EventTypes.h>
-#include <Event/eventReceiverClient.h>
 #include <Event/msg_profile.h>
 
 #include <TH1.h>
@@ -71,9 +72,8 @@ CemcMon::~CemcMon()
     delete iter;
   }
 
-  delete WaveformProcessingFast;
+  delete caloDecoder;
   delete WaveformProcessingTemp;
-  delete erc;
   return;
 }
 
@@ -194,7 +194,7 @@ int CemcMon::Init()
   // }
 
   // initialize waveform extraction tool
-  WaveformProcessingFast = new CaloWaveformFitting();
+  caloDecoder = new CaloPacketDecoder();
 
   WaveformProcessingTemp = new CaloWaveformFitting();
 
@@ -209,10 +209,11 @@ int CemcMon::Init()
   }
   cemctemplate += std::string("/testbeam_cemc_template.root");
   WaveformProcessingTemp->initialize_processing(cemctemplate);
+  WaveformProcessingTemp->set_nthreads(fitThreads);
 
   if (anaGL1)
   {
-    erc = new eventReceiverClient("gl1daq");
+    gl1service = GL1Service::instance("gl1daq");
   }
 
   return 0;
@@ -223,6 +224,12 @@ int CemcMon::BeginRun(const int /* runno */)
   // if you need to read calibrations on a run by run basis
   // this is the place to do it
 
+  // the gl1 events of the previous run are gone
+  if (gl1service)
+  {
+    gl1service->Reset();
+  }
+
   // reset the running means
   std::vector<runningMean *>::iterator rm_it;
   for (rm_it = rm_vector_twr.begin(); rm_it != rm_vector_twr.end(); ++rm_it)
@@ -272,63 +279,31 @@ std::vector<float> CemcMon::getSignal(Packet *p, const int channel)
   return result;
 }
 
-std::vector<float> CemcMon::anaWaveformFast(Packet *p, const int channel)
+// template fit of the high amplitude waveforms collected over the whole event
+// template fit of the channels collected so far in this event, fills the chi2 map
+void CemcMon::anaWaveformTemp()
 {
-  std::vector<float> waveform;
-
-  // int nSamples = p->iValue(0, "SAMPLES");
-  if (p->iValue(channel, "SUPPRESSED"))
+  m_fitresultsTemp.clear();
+  if (!m_waveformsTemp.empty())
   {
-    waveform.push_back(p->iValue(channel, "PRE"));
-    waveform.push_back(p->iValue(channel, "POST"));
+    m_fitresultsTemp = WaveformProcessingTemp->process_waveform(m_waveformsTemp);
   }
-  else
+  for (size_t i = 0; i < m_fitresultsTemp.size(); i++)
   {
-    int nSamples = p->iValue(0, "SAMPLES");
-    waveform.reserve(nSamples);
-    for (int s = 0; s < nSamples; s++)
+    float chi2 = m_fitresultsTemp[i].at(3);
+    float signalTemp = m_fitresultsTemp[i].at(0);
+    if (chi2 > signalTemp * signalTemp / 50.)
     {
-      waveform.push_back(p->iValue(s, channel));
+      p2_bad_chi2->Fill(m_etaphiTemp[i].first, m_etaphiTemp[i].second, 1);
     }
-  }
-
-  std::vector<std::vector<float>> multiple_wfs;
-  multiple_wfs.push_back(waveform);
-
-  std::vector<std::vector<float>> fitresults_cemc;
-  fitresults_cemc = WaveformProcessingFast->calo_processing_fast(multiple_wfs);
-
-  std::vector<float> result;
-  result = fitresults_cemc.at(0);
-  return result;
-}
-
-std::vector<float> CemcMon::anaWaveformTemp(Packet *p, const int channel)
-{
-  std::vector<float> waveform;
-
-  if (p->iValue(channel, "SUPPRESSED"))
-  {
-    waveform.push_back(p->iValue(channel, "PRE"));
-    waveform.push_back(p->iValue(channel, "POST"));
-  }
-  else
-  {
-    waveform.reserve(p->iValue(0, "SAMPLES"));
-    for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
+    else
     {
-      waveform.push_back(p->iValue(s, channel));
+      p2_bad_chi2->Fill(m_etaphiTemp[i].first, m_etaphiTemp[i].second, 0);
     }
   }
-  std::vector<std::vector<float>> multiple_wfs;
-  multiple_wfs.push_back(waveform);
-
-  std::vector<std::vector<float>> fitresults_cemc;
-  fitresults_cemc = WaveformProcessingTemp->process_waveform(multiple_wfs);
-
-  std::vector<float> result;
-  result = fitresults_cemc.at(0);
-  return result;
+  m_waveformsTemp.clear();
+  m_etaphiTemp.clear();
+  return;
 }
 
 int CemcMon::process_event(Event *e /* evt */)
@@ -344,18 +319,18 @@ int CemcMon::process_event(Event *e /* evt */)
   if (anaGL1)
   {
     int evtnr = e->getEvtSequence();
-    Event *gl1Event = erc->getEvent(evtnr);
-    if (gl1Event)
+    GL1Data gl1;
+    gl1service->getGL1Data(evtnr, gl1);
+    if (gl1.haveevent)
     {
       OnlMonServer *se = OnlMonServer::instance();
       se->IncrementGl1FoundCounter();
       have_gl1 = true;
-      Packet *p = gl1Event->getPacket(14001);
       h_evtRec->Fill(0.0, 1.0);
-      if (p)
+      if (gl1.havepacket)
       {
-        gl1_clock = p->lValue(0, "BCO");
-        uint64_t triggervec = p->lValue(0, "ScaledVector");
+        gl1_clock = gl1.bco;
+        uint64_t triggervec = gl1.scaledvector;
         for (int i = 0; i < 64; i++)
         {
           bool trig_decision = ((triggervec & 0x1U) == 0x1U);
@@ -366,9 +341,7 @@ int CemcMon::process_event(Event *e /* evt */)
           }
           triggervec = (triggervec >> 1U) & 0xffffffffU;
         }
-        delete p;
       }
-      delete gl1Event;
     }
     else
     {
@@ -387,6 +360,8 @@ int CemcMon::process_event(Event *e /* evt */)
 
   // loop over packets which contain a single sector
   eventCounter++;
+  m_waveformsTemp.clear();
+  m_etaphiTemp.clear();
   int one = 1;
   int zero = 0;
   for (int packet = packetlow; packet <= packethigh; packet++)
@@ -407,12 +382,16 @@ int CemcMon::process_event(Event *e /* evt */)
         long long int diff = (p_clock - gl1_clock) % 65536;
         h2_caloPack_gl1_clock_diff->Fill(packet, diff);
       }
-      int nChannels = p->iValue(0, "CHANNELS");
+      int nChannels = caloDecoder->Decode(p);
       int skiped_channel = 0;
       if (nChannels > m_nChannels)
       {
+        delete p;
+        anaWaveformTemp();  // the channels of the packets before are good
         return -1;  // packet is corrupted, reports too many channels
       }
+      int nSamples = caloDecoder->getNSamples();
+      caloDecoder->FitFast();  // fast waveform fitting of the whole packet
       //print packet and nCHannels
       for (int c = 0; c < nChannels; c++)
       {
@@ -448,15 +427,15 @@ int CemcMon::process_event(Event *e /* evt */)
         //   if(c>127)continue;
         // }
 
-        std::vector<float> resultFast = anaWaveformFast(p, c);  // fast waveform fitting
-        float signalFast = resultFast.at(0);
-        float timeFast = resultFast.at(1);
-        float pedestalFast = resultFast.at(2);
+        const CaloFastFit &resultFast = caloDecoder->getFit(c);
+        float signalFast = resultFast.amplitude;
+        float timeFast = resultFast.time;
+        float pedestalFast = resultFast.pedestal;
         int bin = h2_cemc_mean->FindBin(eta_bin + 0.5, phi_bin + 0.5);
         //________________________________for this part we only want to deal with the MBD>=1 trigger
         if (fillhist)
         {
-          if (p->iValue(c, "SUPPRESSED"))
+          if (caloDecoder->isSuppressed(c))
           {
             p2_zsFrac_etaphi->Fill(eta_bin, phi_bin, 0);
           }
@@ -485,7 +464,7 @@ int CemcMon::process_event(Event *e /* evt */)
         }
         //_______________________________________________________end of MBD trigger requirement
 
-         if (p->iValue(c, "SUPPRESSED"))
+         if (caloDecoder->isSuppressed(c))
           {
             p2_zsFrac_etaphi_all->Fill(eta_bin, phi_bin, 0);
           }
@@ -501,9 +480,9 @@ int CemcMon::process_event(Event *e /* evt */)
           // check if hot tower and skip it
           if (!isHottower(packet, c))
           {
-            for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
+            for (int s = 0; s < nSamples; s++)
             {
-              h2_waveform_twrAvg->Fill(s, p->iValue(s, c) - pedestalFast);
+              h2_waveform_twrAvg->Fill(s, caloDecoder->getSample(c, s) - pedestalFast);
             }
             h1_waveform_time->Fill(timeFast);
           }
@@ -531,17 +510,17 @@ int CemcMon::process_event(Event *e /* evt */)
 
         if (signalFast > chi2_check_threshold)
         {
-          std::vector<float> resultTemp = anaWaveformTemp(p, c);  // template waveform fitting
-          float chi2 = resultTemp.at(3);
-          float signalTemp = resultTemp.at(0);
-          if(chi2 > signalTemp*signalTemp / 50. )
+          // template fit is done for all packets at once after the packet loop
+          if (caloDecoder->isSuppressed(c))
           {
-            p2_bad_chi2->Fill(eta_bin, phi_bin, 1);
+            m_waveformsTemp.push_back({caloDecoder->getPre(c), caloDecoder->getPost(c)});
           }
           else
           {
-            p2_bad_chi2->Fill(eta_bin, phi_bin, 0);
+            const float *waveform = caloDecoder->getWaveform(c);
+            m_waveformsTemp.emplace_back(waveform, waveform + nSamples);
           }
+          m_etaphiTemp.emplace_back(eta_bin, phi_bin);
         }
         
 
@@ -617,6 +596,8 @@ int CemcMon::process_event(Event *e /* evt */)
     }  // zero filling bad packets
   }    // packet loop
 
+  anaWaveformTemp();  // template waveform fitting
+
   h1_event->Fill(0);
 
   eventCounter++;
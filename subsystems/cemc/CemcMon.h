@@ -3,8 +3,10 @@
 
 #include <onlmon/OnlMon.h>
 
+#include <utility>
 #include <vector>
 
+class CaloPacketDecoder;
 class CaloWaveformFitting;
 class TowerInfoContainer;
 class Event;
@@ -15,7 +17,7 @@ class TProfile;
 class TProfile2D;
 class Packet;
 class runningMean;
-class eventReceiverClient;
+class GL1Service;
 class CDBTTree;
 
 class CemcMon : public OnlMon
@@ -33,11 +35,16 @@ class CemcMon : public OnlMon
     anaGL1 = state;
     return;
   }
+  // number of threads used by the template fit of the high amplitude channels
+  void set_fitThreads(const int n)
+  {
+    fitThreads = n;
+    return;
+  }
 
  protected:
   std::vector<float> getSignal(Packet* p, const int channel);
-  std::vector<float> anaWaveformFast(Packet* p, const int channel);
-  std::vector<float> anaWaveformTemp(Packet* p, const int channel);
+  void anaWaveformTemp();
 
   int idummy = 0;
   TH1* h1_cemc_adc = nullptr;
@@ -86,12 +93,18 @@ class CemcMon : public OnlMon
 
   std::string runtypestr = "Unknown";
 
-  eventReceiverClient* erc = {nullptr};
+  GL1Service* gl1service = {nullptr};  // shared, not owned
   bool anaGL1 = true;
   bool usembdtrig = true;
 
-  CaloWaveformFitting* WaveformProcessingFast = nullptr;
+  CaloPacketDecoder* caloDecoder = nullptr;
   CaloWaveformFitting* WaveformProcessingTemp = nullptr;
+  int fitThreads = 1;
+
+  // high amplitude channels of the whole event, template fitted in one batch
+  std::vector<std::vector<float>> m_waveformsTemp;
+  std::vector<std::pair<unsigned int, unsigned int>> m_etaphiTemp;
+  std::vector<std::vector<float>> m_fitresultsTemp;
 
   bool isHottower(int pid, int channelid)
   {
@@ -113,6 +113,34 @@ int CemcMonDraw::Init()
 
   MakeZSPalette();
 
+  // histograms each canvas needs, cemcDraw(what) fetches only those
+  AddCanvasHisto("FIRST", "h2_cemc_rmhits");
+  AddCanvasHisto("FIRST", "h1_event");
+  AddCanvasHisto("SECOND", "h1_event");
+  AddCanvasHisto("SECOND", "h1_packet_number");
+  AddCanvasHisto("SECOND", "h1_packet_length");
+  AddCanvasHisto("SECOND", "h1_packet_chans");
+  AddCanvasHisto("THIRD", "h2_waveform_twrAvg");
+  AddCanvasHisto("THIRD", "h1_waveform_time");
+  AddCanvasHisto("THIRD", "h1_waveform_pedestal");
+  AddCanvasHisto("FOURTH", "h1_fitting_sigDiff");
+  AddCanvasHisto("FOURTH", "h1_fitting_pedDiff");
+  AddCanvasHisto("FOURTH", "h1_fitting_timeDiff");
+  for (int itrig = 0; itrig < 64; itrig++)
+  {
+    AddCanvasHisto("FIFTH", Form("h2_cemc_hits_trig_bit_%d", itrig));
+  }
+  AddCanvasHisto("FIFTH", "h1_cemc_trig");
+  AddCanvasHisto("FIFTH", "h_evtRec");
+  AddCanvasHisto("SERVERSTATS", "FrameWorkVars");
+  AddCanvasHisto("ALLTRIGHITS", "h2_cemc_rmhits_alltrig");
+  AddCanvasHisto("ALLTRIGHITS", "h1_event");
+  AddCanvasHisto("BADCHI2", "p2_bad_chi2");
+  AddCanvasHisto("SEVENTH", "p2_zsFrac_etaphi");
+  AddCanvasHisto("SEVENTH", "p2_zsFrac_etaphi_all");
+  AddCanvasHisto("ALLTRIGZS", "p2_zsFrac_etaphi");
+  AddCanvasHisto("ALLTRIGZS", "p2_zsFrac_etaphi_all");
+
   return 0;
 }
 
@@ -136,13 +136,12 @@ int DaqMon::process_event(Event *e /* evt */)
     {
       gl1status = gl1mgr->getClockSync(e->getEvtSequence(), plist[0] );
 
-      Packet *pgl1 = gl1mgr->getGL1Packet();
-      if (pgl1)
+      const GL1Data *gl1 = gl1mgr->getGL1Data();
+      if (gl1)
 	{
           OnlMonServer *se = OnlMonServer::instance();
           se->IncrementGl1FoundCounter();
-	  gl1_clock = pgl1->lValue(0, "BCO");
-	  delete pgl1;
+	  gl1_clock = gl1->bco;
 	}
     }
 
@@ -5,8 +5,11 @@
 
 #include "HcalMon.h"
 
+#include <onlmon/CaloPacketDecoder.h>
+#include <onlmon/GL1Service.h>
 #include <onlmon/OnlMon.h>  // for OnlMon
 #include <onlmon/OnlMonDB.h>
+#include <onlmon/OnlMonHistory.h>
 #include <onlmon/OnlMonServer.h>
 #include <onlmon/pseudoRunningMean.h>
 
@@ -14,7 +17,6 @@
 #include <caloreco/CaloWaveformFitting.h>
 
 #include <Event/Event.h>
-#include <Event/eventReceiverClient.h>
 #include <Event/msg_profile.h>
 
 #include <TH1.h>
@@ -64,6 +66,7 @@ HcalMon::~HcalMon()
 {
   // you can delete NULL pointers it results in a NOOP (No Operation)
   delete WaveformProcessing;
+  delete caloDecoder;
   for (auto iter : rm_vector_sectAvg)
   {
     delete iter;
@@ -97,11 +100,6 @@ HcalMon::~HcalMon()
     delete iter;
   }
 
-  if (erc)
-  {
-    delete erc;
-  }
-
   return;
 }
 
@@ -241,6 +239,7 @@ int HcalMon::Init()
 
   // initialize waveform extraction tool
   WaveformProcessing = new CaloWaveformFitting();
+  caloDecoder = new CaloPacketDecoder();
 
   std::string hcaltemplate;
   if (getenv("HCALCALIB"))
@@ -256,7 +255,7 @@ int HcalMon::Init()
 
   if (anaGL1)
   {
-    erc = new eventReceiverClient("gl1daq");
+    gl1service = GL1Service::instance("gl1daq");
   }
 
   return 0;
@@ -291,38 +290,6 @@ std::vector<float> HcalMon::getSignal(Packet* p, const int channel)
   return result;
 }
 
-std::vector<float> HcalMon::anaWaveform(Packet* p, const int channel)
-{
-  std::vector<float> waveform;
-  // waveform.reserve(p->iValue(0, "SAMPLES"));
-  float supppressed = 1;
-  if (p->iValue(channel, "SUPPRESSED"))
-  {
-    waveform.push_back(p->iValue(channel, "PRE"));
-    waveform.push_back(p->iValue(channel, "POST"));
-  }
-  else
-  {
-    supppressed = 0;
-    for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
-    {
-      waveform.push_back(p->iValue(s, channel));
-    }
-  }
-  std::vector<std::vector<float>> multiple_wfs;
-  multiple_wfs.push_back(waveform);
-
-  std::vector<std::vector<float>> fitresults_ohcal;
-  // fitresults_ohcal = WaveformProcessing->process_waveform(multiple_wfs);
-  fitresults_ohcal = WaveformProcessing->calo_processing_fast(multiple_wfs);
-
-  std::vector<float> result;
-  result = fitresults_ohcal.at(0);
-  result.push_back(supppressed);
-
-  return result;
-}
-
 int HcalMon::BeginRun(const int /* runno */)
 {
   //reset the thresholds
@@ -332,6 +299,12 @@ int HcalMon::BeginRun(const int /* runno */)
   // if you need to read calibrations on a run by run basis
   // this is the place to do it
 
+  // the gl1 events of the previous run are gone
+  if (gl1service)
+  {
+    gl1service->Reset();
+  }
+
   std::vector<runningMean*>::iterator rm_it;
   for (rm_it = rm_vector_sectAvg.begin(); rm_it != rm_vector_sectAvg.end(); ++rm_it)
   {
@@ -398,18 +371,18 @@ int HcalMon::process_event(Event* e /* evt */)
   if (anaGL1)
   {
     int evtnr = e->getEvtSequence();
-    Event* gl1Event = erc->getEvent(evtnr);
-    if (gl1Event)
+    GL1Data gl1;
+    gl1service->getGL1Data(evtnr, gl1);
+    if (gl1.haveevent)
     {
       OnlMonServer *se = OnlMonServer::instance();
       se->IncrementGl1FoundCounter();
       have_gl1 = true;
-      Packet* p = gl1Event->getPacket(14001);
       h_evtRec->Fill(0.0, 1.0);
-      if (p)
+      if (gl1.havepacket)
       {
-        gl1_clock = p->lValue(0, "BCO");
-        uint64_t triggervec = p->lValue(0, "ScaledVector");
+        gl1_clock = gl1.bco;
+        uint64_t triggervec = gl1.scaledvector;
         for (int i = 0; i < 64; i++)
         {
           bool trig_decision = ((triggervec & 0x1U) == 0x1U);
@@ -421,10 +394,7 @@ int HcalMon::process_event(Event* e /* evt */)
           }
           triggervec = (triggervec >> 1U) & 0xffffffffU;
         }
-
-        delete p;
       }
-      delete gl1Event;
     }
     else
     {
@@ -469,9 +439,10 @@ int HcalMon::process_event(Event* e /* evt */)
         long long int diff = (p_clock - gl1_clock) % 65536;
         h_caloPack_gl1_clock_diff->Fill(packet, diff);
       }
-      int nChannels = p->iValue(0, "CHANNELS");
+      int nChannels = caloDecoder->Decode(p);
       if (nChannels > m_nChannels)
       {
+        delete p;
         return -1;  // packet is corrupted, reports too many channels
       }
       else
@@ -480,16 +451,18 @@ int HcalMon::process_event(Event* e /* evt */)
         rm_packet_chans[packet - packetlow]->Add(&nChannels);
         h1_packet_chans->SetBinContent(packet_bin, rm_packet_chans[packet - packetlow]->getMean(0));
       }
+      int nSamples = caloDecoder->getNSamples();
+      caloDecoder->FitFast();  // fast waveform fitting of the whole packet
       for (int c = 0; c < nChannels; c++)
       {
         towerNumber++;
 
         // std::vector result =  getSignal(p,c); // simple peak extraction
-        std::vector<float> result = anaWaveform(p, c);  // full waveform fitting
-        float signal = result.at(0);
-        float time = result.at(1);
-        float pedestal = result.at(2);
-        float suppressed = result.at(result.size() - 1);
+        const CaloFastFit& result = caloDecoder->getFit(c);
+        float signal = result.amplitude;
+        float time = result.time;
+        float pedestal = result.pedestal;
+        bool suppressed = caloDecoder->isSuppressed(c);
         if (signal > 15 && signal < 15000)
         {
           energy1 += signal;
@@ -515,7 +488,7 @@ int HcalMon::process_event(Event* e /* evt */)
           }
           h_waveform_pedestal->Fill(pedestal);
 
-          if (suppressed == 1)
+          if (suppressed)
           {
             pr_zsFrac_etaphi->Fill(eta_bin, phi_bin, 0);
           }
@@ -533,30 +506,14 @@ int HcalMon::process_event(Event* e /* evt */)
           h2_hcal_rm->SetBinContent(bin, rm_vector_twrhit[towerNumber - 1]->getMean(0));
           h2_hcal_time->SetBinContent(bin, rm_vector_twrTime[towerNumber - 1]->getMean(0));
 
-          // fill tower_rm here
-          if (evtcnt <= historyLength * historyScaleDown)
-          {
-            // only fill every scaledown event
-            if (evtcnt % historyScaleDown == 0)
-            {
-              h_rm_tower[eta_bin][phi_bin]->SetBinContent(evtcnt / historyScaleDown, rm_vector_twrhit[towerNumber - 1]->getMean(0));
-            }
-          }
-          else
+          // fill tower_rm here, only every scaledown event
+          if (evtcnt % historyScaleDown == 0)
           {
-            // only fill every scaledown event
-            if (evtcnt % historyScaleDown == 0)
-            {
-              for (int ib = 1; ib < historyLength; ib++)
-              {
-                h_rm_tower[eta_bin][phi_bin]->SetBinContent(ib, h_rm_tower[eta_bin][phi_bin]->GetBinContent(ib + 1));
-              }
-              h_rm_tower[eta_bin][phi_bin]->SetBinContent(historyLength, rm_vector_twrhit[towerNumber - 1]->getMean(0));
-            }
+            OnlMonHistory::Fill(h_rm_tower[eta_bin][phi_bin], rm_vector_twrhit[towerNumber - 1]->getMean(0));
           }
         }
         //_______________________________________________________end of MBD trigger requirement
-          if (suppressed == 1)
+          if (suppressed)
           {
             pr_zsFrac_etaphi_all->Fill(eta_bin, phi_bin, 0);
           }
@@ -565,12 +522,13 @@ int HcalMon::process_event(Event* e /* evt */)
             pr_zsFrac_etaphi_all->Fill(eta_bin, phi_bin, 1);
           }
         // record waveform
-        for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
+        const float* waveform = caloDecoder->getWaveform(c);
+        for (int s = 0; s < nSamples; s++)
         {
-          h_waveform_twrAvg->Fill(s, p->iValue(s, c));
+          h_waveform_twrAvg->Fill(s, waveform[s]);
           if (signal > waveform_hit_threshold)
           {
-            h2_hcal_waveform->Fill(s, (p->iValue(s, c) - pedestal));
+            h2_hcal_waveform->Fill(s, (waveform[s] - pedestal));
           }
         }
         if (signal > waveform_hit_threshold)
@@ -619,20 +577,21 @@ int HcalMon::process_event(Event* e /* evt */)
       Packet* p = e->getPacket(i);
       if (p)
       {
-        int nChannels = p->iValue(0, "CHANNELS");
+        int nChannels = caloDecoder->Decode(p);
         if (nChannels > m_nChannels)
         {
+          delete p;
           return -1;  // packet is corrupted, reports too many channels
         }
         else
         {
           npacket2++;
         }
+        caloDecoder->FitFast();
         for (int c = 0; c < nChannels; c++)
         {
           // std::vector result =  getSignal(p,c); // simple peak extraction
-          std::vector<float> result = anaWaveform(p, c);  // full waveform fitting
-          float signal = result.at(0);
+          float signal = caloDecoder->getFit(c).amplitude;
           if (signal > 15 && signal < 15000)
           {
             energy2 += signal;
@@ -659,25 +618,10 @@ int HcalMon::process_event(Event* e /* evt */)
     sectorAvg[isec] /= 48;
     h_sectorAvg_total->Fill(isec + 1, sectorAvg[isec]);
     rm_vector_sectAvg[isec]->Add(&sectorAvg[isec]);
-    if (evtcnt <= historyLength * historyScaleDown)
-    {
-      // only fill every scaledown event
-      if (evtcnt % historyScaleDown == 0)
-      {
-        h_rm_sectorAvg[isec]->SetBinContent(evtcnt / historyScaleDown, rm_vector_sectAvg[isec]->getMean(0));
-      }
-    }
-    else
+    // only fill every scaledown event
+    if (evtcnt % historyScaleDown == 0)
     {
-      // only fill every scaledown event
-      if (evtcnt % historyScaleDown == 0)
-      {
-        for (int ib = 1; ib < historyLength; ib++)
-        {
-          h_rm_sectorAvg[isec]->SetBinContent(ib, h_rm_sectorAvg[isec]->GetBinContent(ib + 1));
-        }
-        h_rm_sectorAvg[isec]->SetBinContent(historyLength, rm_vector_sectAvg[isec]->getMean(0));
-      }
+      OnlMonHistory::Fill(h_rm_sectorAvg[isec], rm_vector_sectAvg[isec]->getMean(0));
     }
 
   }  // sector loop
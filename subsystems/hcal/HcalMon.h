@@ -5,6 +5,7 @@
 
 #include <vector>
 
+class CaloPacketDecoder;
 class CaloWaveformFitting;
 class TowerInfoContainer;
 class Event;
@@ -14,7 +15,7 @@ class TProfile2D;
 class TH2;
 class Packet;
 class runningMean;
-class eventReceiverClient;
+class GL1Service;
 
 class HcalMon : public OnlMon
 {
@@ -27,7 +28,6 @@ class HcalMon : public OnlMon
   int BeginRun(const int runno);
   int Reset();
   std::vector<float> getSignal(Packet* p, const int channel);
-  std::vector<float> anaWaveform(Packet* p, const int channel);
   void set_anaGL1(bool state)
   {
     anaGL1 = state;
@@ -76,7 +76,8 @@ class HcalMon : public OnlMon
   TH2* h_caloPack_gl1_clock_diff {nullptr};
   TProfile* h_evtRec {nullptr};
   CaloWaveformFitting* WaveformProcessing {nullptr};
-  eventReceiverClient* erc {nullptr};
+  CaloPacketDecoder* caloDecoder {nullptr};
+  GL1Service* gl1service {nullptr};  // shared, not owned
 
   int evtcnt {0};
   int idummy {0};
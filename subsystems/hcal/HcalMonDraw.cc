@@ -1,6 +1,7 @@
 #include "HcalMonDraw.h"
 
 #include <onlmon/OnlMonClient.h>
+#include <onlmon/OnlMonHistory.h>
 
 #include <TAxis.h>  // for TAxis
 #include <TButton.h>
@@ -780,6 +781,9 @@ int HcalMonDraw::DrawSecond(const std::string& /* what */)
   {
     h_rm_sectorAvg[ih] =  cl->getHisto(hcalmon[0], Form("h_rm_sectorAvg_s%d", ih));
     h_rm_sectorAvg_1[ih] =  cl->getHisto(hcalmon[1], Form("h_rm_sectorAvg_s%d", ih));
+    // history plots come as ring buffers, put them into time order before adding
+    OnlMonHistory::Unroll(h_rm_sectorAvg[ih]);
+    OnlMonHistory::Unroll(h_rm_sectorAvg_1[ih]);
     h_rm_sectorAvg[ih]->Add(h_rm_sectorAvg_1[ih]);
   }
 
@@ -2092,6 +2096,8 @@ void HcalMonDraw::HandleEvent(int event, int x, int y, TObject* selected)
       TC[4]->SetEditable(false);
       return;
     }
+    OnlMonHistory::Unroll(h_rm_tower);
+    OnlMonHistory::Unroll(h_rm_tower_1);
     h_rm_tower->Add(h_rm_tower_1);
     h_rm_tower->SetXTitle("Time");
     h_rm_tower->SetYTitle("Running Mean");
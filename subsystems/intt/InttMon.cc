@@ -8,6 +8,7 @@
 #include <TH1.h>
 #include <TH2.h>
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 
@@ -32,8 +33,9 @@ int InttMon::Init()
   // GetBinContent(2): # of unique BCOs
   // GetBinContent(3): BCO order error
   // GetBinContent(4): Time at SOR as seconds since epoch
-  // GetBinContent(4): Time at present or EOR as seconds since epoch
-  EvtHist = new TH1I("InttEvtHist", "InttEvtHist", 5, 0.0, 1.0);
+  // GetBinContent(5): Time at present or EOR as seconds since epoch
+  // GetBinContent(6): # of BCOs older than the unique BCO window (not counted)
+  EvtHist = new TH1I("InttEvtHist", "InttEvtHist", 6, 0.0, 1.0);
   HitHist = new TH1D("InttHitHist", "InttHitHist", (NFEES * NCHIPS), 0.0, 1.0); // 26*14
   BcoHist = new TH2D("InttBcoHist", "InttBcoHist", 2, 0.0, 1.0, (NFEES * NBCOS), 0.0, 1.0); // 128*14
 
@@ -46,6 +48,8 @@ int InttMon::Init()
   se->registerHisto(this, LogHist);
   //...
 
+  m_bco_ring.assign(m_BCO_WINDOW, m_EMPTY_BCO_SLOT);
+
   return 0;
 }
 
@@ -56,10 +60,10 @@ int InttMon::BeginRun(const int /* run_num */)
   BcoHist->Reset();
   LogHist->Reset();
 
-  m_unique_bcos.clear();
+  std::fill(m_bco_ring.begin(), m_bco_ring.end(), m_EMPTY_BCO_SLOT);
   m_unique_bco_count = 0;
+  m_bco_overflow_count = 0;
   m_most_recent_bco = std::numeric_limits<unsigned long long>::max();
-  m_last_flushed_bco = std::numeric_limits<unsigned long long>::max();
 
   m_log_bin = 0;
   m_logged_bcos = 0;
@@ -101,55 +105,15 @@ int InttMon::process_event(Event *evt)
 	// bcos
 	for (int n = 0; n < pkt->iValue(0, "NR_BCOS"); ++n)
 	{
-      unsigned long long bco_full = pkt->lValue(n, "BCOLIST");
-
-  	  // more recent that the variable we track it with, or variable we track it with hasn't been set to a "real" value yet
-  	  if(m_bco_less(m_most_recent_bco, bco_full) || (m_most_recent_bco == std::numeric_limits<unsigned long long>::max()))
-  	  {
-          m_most_recent_bco = bco_full;
-  	  }
-
-  	  // make sure it's not in the range of bcos we've "flushed" into our counter (and that the variable we track it with has been set to a "real" value)
-  	  // This check should be moot--the fees have their BCOs in order--but I leave it in anyways b/c it is not expensive and confirms this assumption
-  	  if(!m_bco_less(m_last_flushed_bco, bco_full) && (m_last_flushed_bco != std::numeric_limits<unsigned long long>::max()))
-  	  {
-          EvtHist->SetBinContent(3, 1);
-		  continue;
-  	  }
-
-  	  m_unique_bcos.insert(bco_full);
+      AddBco(pkt->lValue(n, "BCOLIST"));
 	}
 
     delete pkt;
   }
 
-  // Go through our list of unique BCOs and "flush" them into a counter
-  if(100 < m_unique_bcos.size())
-  {
-    std::set<unsigned long long, bco_comparator_s>::const_iterator bco_itr = m_unique_bcos.begin();
-    // for(bco_itr = m_unique_bcos.begin(); bco_itr != m_unique_bcos.end(); ++bco_itr)
-    for(int n = 0; n < 10; ++n)
-    {
-      if(bco_itr == m_unique_bcos.end())
-      {
-	    break;
-      }
-
-      // if((m_most_recent_bco == std::numeric_limits<unsigned long long>::max()) || m_bco_less(m_most_recent_bco - m_MAX_BCO_DIFF, *bco_itr))
-      if( m_most_recent_bco == std::numeric_limits<unsigned long long>::max() )
-      {
-        break;
-      }
-
-      ++m_unique_bco_count;
-      m_last_flushed_bco = *bco_itr;
-	  ++bco_itr;
-    }
-    m_unique_bcos.erase(m_unique_bcos.begin(), bco_itr);
-  }
-
   EvtHist->AddBinContent(1);
-  EvtHist->SetBinContent(2, m_unique_bco_count + m_unique_bcos.size());
+  EvtHist->SetBinContent(2, m_unique_bco_count);
+  EvtHist->SetBinContent(6, m_bco_overflow_count);
 
 
   std::chrono::time_point<std::chrono::system_clock> const now = std::chrono::system_clock::now();
@@ -166,7 +130,7 @@ int InttMon::process_event(Event *evt)
   // See if we should increment m_log_bin
   while(logged_seconds < seconds)
   {
-    m_logged_bcos = m_unique_bco_count + m_unique_bcos.size();
+    m_logged_bcos = m_unique_bco_count;
 
 	if(m_log_bin == N - 1)
 	{
@@ -180,17 +144,16 @@ int InttMon::process_event(Event *evt)
 	logged_seconds += m_LOG_INTERVAL;
   }
 
-  LogHist->SetBinContent(m_log_bin, m_unique_bco_count + m_unique_bcos.size() - m_logged_bcos);
+  LogHist->SetBinContent(m_log_bin, m_unique_bco_count - m_logged_bcos);
 
-  // if(m_unique_bco_count + m_unique_bcos.size() - m_logged_bcos)
+  // if(m_unique_bco_count - m_logged_bcos)
   // {
-  //   std::cout << "decoded " << m_unique_bco_count + m_unique_bcos.size() - m_logged_bcos << std::endl;
+  //   std::cout << "decoded " << m_unique_bco_count - m_logged_bcos << std::endl;
   // }
 
   // if(!((int)(EvtHist->GetBinContent(1)) % m_evt_per_cout))
   // {
   //   std::cout << std::hex;
-  //   std::cout << "last flushed: 0x" << m_last_flushed_bco << std::endl;
   //   std::cout << "most recent:  0x" << m_most_recent_bco << std::endl;
   //   std::cout << std::dec;
   // }
@@ -199,6 +162,31 @@ int InttMon::process_event(Event *evt)
   return 0;
 }
 
+int InttMon::AddBco(unsigned long long const& bco_full)
+{
+  // more recent that the variable we track it with, or variable we track it with hasn't been set to a "real" value yet
+  if (m_most_recent_bco == std::numeric_limits<unsigned long long>::max() || m_bco_less(m_most_recent_bco, bco_full))
+  {
+    m_most_recent_bco = bco_full;
+  }
+  // too old to tell if we have seen it already, the window is too short for the spread of the BCOs
+  else if ((m_most_recent_bco - bco_full + bco_comparator_s::MAX) % bco_comparator_s::MAX >= m_BCO_WINDOW)
+  {
+    EvtHist->SetBinContent(3, 1);
+    ++m_bco_overflow_count;
+    return -1;
+  }
+
+  uint32_t &slot = m_bco_ring[bco_full & (m_BCO_WINDOW - 1)];
+  uint32_t tag = (bco_full % bco_comparator_s::MAX) >> m_BCO_WINDOW_BITS;
+  if (slot != tag)
+  {
+    slot = tag;
+    ++m_unique_bco_count;
+  }
+  return 0;
+}
+
 int InttMon::Reset()
 {
   	return 0;
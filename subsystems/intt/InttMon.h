@@ -4,8 +4,9 @@
 #include <onlmon/OnlMon.h>
 
 #include <chrono>
-#include <set>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 class Packet;
 class TH1;
@@ -44,11 +45,21 @@ class InttMon : public OnlMon
 	  unsigned long long static const MAX = (unsigned long long){1} << 40;
 	  bool operator()(unsigned long long const&, unsigned long long const&) const;
   } const m_bco_less{};
-  std::set<unsigned long long, bco_comparator_s> m_unique_bcos;
+
+  // Unique BCOs are counted in a sliding window of 2^m_BCO_WINDOW_BITS crossings
+  // behind the most recent BCO. Each BCO owns the ring slot (BCO modulo window)
+  // holding its upper bits, so a BCO is new if its slot holds different upper bits.
+  // BCOs older than the window can't be checked anymore and are counted as overflows.
+  static constexpr int m_BCO_WINDOW_BITS = 18;
+  static constexpr unsigned long long m_BCO_WINDOW = 1ULL << m_BCO_WINDOW_BITS;
+  static constexpr uint32_t m_EMPTY_BCO_SLOT = 0xffffffffU;
+  int AddBco(unsigned long long const& bco_full);
+
+  std::vector<uint32_t> m_bco_ring;
   unsigned long long m_most_recent_bco = 0;
-  unsigned long long m_last_flushed_bco = 0; 
 
   int m_unique_bco_count = {};
+  int m_bco_overflow_count = {};
   int m_log_bin = 0;
   int m_logged_bcos = 0;
   int m_evt_per_cout = 50000;
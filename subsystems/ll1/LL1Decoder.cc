@@ -0,0 +1,276 @@
+#include "LL1Decoder.h"
+
+#include <Event/Event.h>
+#include <Event/EventTypes.h>
+#include <Event/msg_profile.h>
+
+#include <algorithm>
+#include <cstring>  // for memset
+#include <iostream>
+
+LL1HEADER &LL1Decoder::Decode(Event *evt)
+{
+  Clear();
+  for (int ixmit = 0; ixmit < NXMIT; ixmit++)
+  {
+    int pid = PACKET[ixmit];
+    Packet *p = evt->getPacket(pid);
+    if (!p)
+    {
+      continue;
+    }
+    m_Header.runnumber = evt->getRunNumber();
+    m_Header.evtnr = p->iValue(0, "EVTNR");
+    m_Header.clock = p->lValue(0, "CLOCK");
+    m_Header.monitor = p->iValue(0, "MONITOR");
+    m_Header.nsamples = p->iValue(0, "SAMPLES");
+
+    if (pid == 13002)
+    {
+      ProcessJet(p);
+    }
+    else if (pid >= 13010)
+    {
+      ProcessEmcal(pid, p);
+    }
+    else if (pid == 13001)
+    {
+      ProcessMbd(p);
+    }
+    delete p;
+  }
+  ProcessThresholds(evt);
+  return m_Header;
+}
+
+void LL1Decoder::Clear()
+{
+  // only what Decode() fills, everything else is never touched
+  m_Header.runnumber = 0;
+  m_Header.evtnr = 0;
+  m_Header.clock = 0;
+  m_Header.monitor = 0;
+  m_Header.nsamples = NRSAM;
+  m_Header.hit_format_jet = 0;
+  m_Header.idxsample = 0;
+  m_Header.idxhitn = 0;
+  m_Header.idxhits = 0;
+  memset(m_Header.channel, 0, sizeof(m_Header.channel));
+  memset(m_Header.triggerwords, 0, sizeof(m_Header.triggerwords));
+  for (int *array : {m_Header.nhit_n1, m_Header.nhit_n2, m_Header.nhit_s1, m_Header.nhit_s2, m_Header.nhit_n, m_Header.nhit_s,
+                     m_Header.chargesum_s1, m_Header.chargesum_s2, m_Header.chargesum_n1, m_Header.chargesum_n2, m_Header.chargesum_s, m_Header.chargesum_n,
+                     m_Header.timesum_s1, m_Header.timesum_s2, m_Header.timesum_n1, m_Header.timesum_n2, m_Header.timesum_s, m_Header.timesum_n})
+  {
+    std::fill(array, array + NRSAM, 0);
+  }
+  memset(m_Header.jet_input, 0, sizeof(m_Header.jet_input));
+  memset(m_Header.jet_output, 0, sizeof(m_Header.jet_output));
+  memset(m_Header.emcal_2x2_map, 0, sizeof(m_Header.emcal_2x2_map));
+  memset(m_Header.emcal_8x8_map, 0, sizeof(m_Header.emcal_8x8_map));
+  std::fill(std::begin(m_Header.emcal_sample), std::end(m_Header.emcal_sample), -1);
+  std::fill(std::begin(m_Header.jet_sample), std::end(m_Header.jet_sample), -1);
+  return;
+}
+
+void LL1Decoder::ProcessMbd(Packet *p)
+{
+  LL1HEADER &ll1h = m_Header;
+  int indx1 = 0;
+  int inhit1 = 0;
+  int indx2 = 0;
+  int inhit2 = 0;
+  for (int is = 0; is < NRSAM; is++)
+  {
+    ll1h.nhit_s1[is] = p->iValue(is, NHITCHANNEL + NADCSH * 0);
+    ll1h.nhit_s2[is] = p->iValue(is, NHITCHANNEL + NADCSH * 1);
+    ll1h.nhit_n1[is] = p->iValue(is, NHITCHANNEL + NADCSH * 2);
+    ll1h.nhit_n2[is] = p->iValue(is, NHITCHANNEL + NADCSH * 3);
+
+    ll1h.nhit_n[is] = ll1h.nhit_n1[is] + ll1h.nhit_n2[is];
+    ll1h.nhit_s[is] = ll1h.nhit_s1[is] + ll1h.nhit_s2[is];
+
+    ll1h.timesum_s1[is] = p->iValue(is, NHITCHANNEL + 1 + NADCSH * 0);
+    ll1h.timesum_s2[is] = p->iValue(is, NHITCHANNEL + 2 + NADCSH * 1);
+    ll1h.timesum_n1[is] = p->iValue(is, NHITCHANNEL + 3 + NADCSH * 2);
+    ll1h.timesum_n2[is] = p->iValue(is, NHITCHANNEL + 4 + NADCSH * 3);
+
+    ll1h.timesum_s[is] = ll1h.timesum_n1[is] + ll1h.timesum_n2[is];
+    ll1h.timesum_n[is] = ll1h.timesum_s1[is] + ll1h.timesum_s2[is];
+
+    if (ll1h.nhit_n[is] > 0 && inhit1 < ll1h.nhit_n[is])
+    {
+      indx1 = is;
+      inhit1 = ll1h.nhit_n[is];
+    }
+    if (ll1h.nhit_s[is] > 0 && inhit2 < ll1h.nhit_s[is])
+    {
+      indx2 = is;
+      inhit2 = ll1h.nhit_s[is];
+    }
+
+    // each channel is read once
+    for (int ic = 0; ic < NCH; ic++)
+    {
+      int value = p->iValue(is, ic);
+      ll1h.channel[ic][is] = value;
+      if (ic < NHITCHANNEL)
+      {
+        ll1h.chargesum_s1[is] += value;
+      }
+      else if (ic >= NADCSH * 1 && ic < NHITCHANNEL + NADCSH * 1)
+      {
+        ll1h.chargesum_s2[is] += value;
+      }
+      else if (ic >= NADCSH * 2 && ic < NHITCHANNEL + NADCSH * 2)
+      {
+        ll1h.chargesum_n1[is] += value;
+      }
+      else if (ic >= NADCSH * 3 && ic < NHITCHANNEL + NADCSH * 3)
+      {
+        ll1h.chargesum_n2[is] += value;
+      }
+    }
+    ll1h.chargesum_n[is] = ll1h.chargesum_n1[is] + ll1h.chargesum_n2[is];
+    ll1h.chargesum_s[is] = ll1h.chargesum_s1[is] + ll1h.chargesum_s2[is];
+
+    for (int it = NCH; it < (NCH + NTRIGWORDS); it++)
+    {
+      ll1h.triggerwords[it - NCH][is] = p->iValue(is, it);
+    }
+  }
+  ll1h.idxhitn = indx1;
+  ll1h.idxhits = indx2;
+  ll1h.idxsample = (ll1h.idxhitn == ll1h.idxhits) ? ll1h.idxhitn : -1;
+  return;
+}
+
+void LL1Decoder::ProcessJet(Packet *p)
+{
+  LL1HEADER &ll1h = m_Header;
+  ll1h.hit_format_jet = p->getHitFormat();
+  const int nsamples = p->iValue(0, "SAMPLES");
+  const int ntriggerwords = p->iValue(0, "TRIGGERWORDS");
+
+  // go through all input fibers
+  for (int i = 0; i < 16; i++)
+  {
+    for (int j = 0; j < 24; j++)
+    {
+      int ieta = j % 12;
+      int iphi = j / 12 + i * 2;
+      for (int is = 0; is < nsamples; is++)
+      {
+        int value = p->iValue(is, iphi + 32 * ieta);
+        if (value)
+        {
+          ll1h.jet_sample[i] = is;
+          ll1h.jet_input[ieta][iphi] = value;
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < ntriggerwords; i++)
+  {
+    for (int is = 0; is < nsamples; is++)
+    {
+      int value = p->iValue(is, 16 * 24 + i);
+      if (value)
+      {
+        ll1h.jet_output[i / 32][i % 32] = value;
+      }
+    }
+  }
+  return;
+}
+
+void LL1Decoder::ProcessEmcal(int pid, Packet *p)
+{
+  LL1HEADER &ll1h = m_Header;
+  const int emcal_board = pid - 13010;
+  const int nchannels = p->iValue(0, "CHANNELS");
+  const int nsamples = p->iValue(0, "SAMPLES");
+  const int ntriggerwords = p->iValue(0, "TRIGGERWORDS");
+
+  // go through all input fibers
+  for (int i = 0; i < nchannels; i++)
+  {
+    for (int is = 0; is < nsamples; is++)
+    {
+      ll1h.emcal_2x2_map[((i / 16) % 12) * 4 + (i % 4)][emcal_board * 8 + (i % 16) / 4] = p->iValue(is, i);
+    }
+  }
+
+  for (int i = 0; i < ntriggerwords; i++)
+  {
+    for (int is = 0; is < nsamples; is++)
+    {
+      int value = p->iValue(is, 16 * 24 + i);
+      if (value)
+      {
+        ll1h.emcal_sample[emcal_board] = is;
+        ll1h.emcal_8x8_map[i % 12][emcal_board * 2 + i / 12] = value;
+      }
+    }
+  }
+  return;
+}
+
+void LL1Decoder::ProcessThresholds(Event *evt)
+{
+  int threshold[nthresholds];
+  Packet *pthresh = evt->getPacket(13901);
+  if (pthresh)
+  {
+    for (int ithreshold = 0; ithreshold < nthresholds; ithreshold++)
+    {
+      threshold[ithreshold] = pthresh->iValue(ithreshold);
+    }
+    delete pthresh;
+    // print them when they change, not for every event
+    if (m_Verbosity > 0 || !m_ThresholdsSeen || !std::equal(threshold, threshold + nthresholds, m_LastThreshold))
+    {
+      for (int ithreshold = 0; ithreshold < nthresholds; ithreshold++)
+      {
+        std::cout << " threshold " << ithreshold << " : " << threshold[ithreshold] << std::endl;
+      }
+      std::copy(threshold, threshold + nthresholds, m_LastThreshold);
+      m_ThresholdsSeen = true;
+    }
+  }
+  else
+  {
+    // defaults
+    for (int ithreshold = 0; ithreshold < nthresholds; ithreshold++)
+    {
+      if (ithreshold < 4)
+      {
+        threshold[ithreshold] = ithreshold + 1;
+      }
+      else if (ithreshold < 8)
+      {
+        threshold[ithreshold] = (ithreshold - 4) + 1;
+      }
+      else
+      {
+        threshold[ithreshold] = 2;
+      }
+    }
+  }
+  for (int ithreshold = 0; ithreshold < nthresholds; ithreshold++)
+  {
+    if (ithreshold < 4)
+    {
+      m_Header.jet_threshold[ithreshold] = threshold[ithreshold];
+    }
+    else if (ithreshold < 8)
+    {
+      m_Header.photon_threshold[ithreshold - 4] = threshold[ithreshold];
+    }
+    else
+    {
+      m_Header.mbd_threshold[ithreshold - 8] = threshold[ithreshold];
+    }
+  }
+  return;
+}
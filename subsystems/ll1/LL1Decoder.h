@@ -0,0 +1,42 @@
+#ifndef LL1_LL1DECODER_H
+#define LL1_LL1DECODER_H
+
+#include "LL1HEADER.h"
+
+class Event;
+class Packet;
+
+// Decodes the LL1 packets of an event into one LL1HEADER which is kept
+// for the lifetime of the decoder. Decode() only clears the parts of the
+// header it fills, so there is no allocation (besides the packets the
+// Event hands out) and no output per event.
+
+class LL1Decoder
+{
+ public:
+  LL1Decoder() = default;
+  ~LL1Decoder() = default;
+
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit LL1Decoder(const LL1Decoder &) = delete;
+  LL1Decoder &operator=(const LL1Decoder &) = delete;
+
+  // the returned header is overwritten by the next call
+  LL1HEADER &Decode(Event *evt);
+
+  void Verbosity(const int i) { m_Verbosity = i; }
+
+ private:
+  void Clear();
+  void ProcessMbd(Packet *p);
+  void ProcessJet(Packet *p);
+  void ProcessEmcal(int pid, Packet *p);
+  void ProcessThresholds(Event *evt);
+
+  LL1HEADER m_Header;
+  int m_Verbosity{0};
+  int m_LastThreshold[nthresholds]{0};
+  bool m_ThresholdsSeen{false};
+};
+
+#endif /* LL1_LL1DECODER_H */
@@ -4,7 +4,7 @@
 // (more info - check the difference in include path search when using "" versus <>)
 
 #include "LL1Mon.h"
-#include "ll1setup.cc"
+#include "LL1Decoder.h"
 
 #include <onlmon/OnlMon.h>  // for OnlMon
 #include <onlmon/OnlMonDB.h>
@@ -41,6 +41,7 @@ LL1Mon::LL1Mon(const std::string &name)
 LL1Mon::~LL1Mon()
 {
   // you can delete NULL pointers it results in a NOOP (No Operation)
+  delete m_Decoder;
   return;
 }
 
@@ -60,6 +61,8 @@ int LL1Mon::Init()
   // use printf for stuff which should go the screen but not into the message
   // system (all couts are redirected)
   printf("doing the Init\n");
+  m_Decoder = new LL1Decoder();
+  m_Decoder->Verbosity(Verbosity());
   h_line_up = new TH2D("h_line_up",";Sample;Channel", 20, -0.5, 19.5, 60, -0.5, 59.5);
   h_nhit_corr = new TH2D("h_nhit_corr",";N_{hit}^{north};N_{hit}^{south}",nhitbins, binstart, binend, nhitbins, binstart, binend);
   //h_nhit_n_corr = new TH2D("h_nhit_n_corr",";N_{hit}^{N1};N_{hit}^{N2}",nhitbins/2 + 1,binstart,binend2,nhitbins/2+1,binstart,binend2);
@@ -140,9 +143,8 @@ int LL1Mon::process_event(Event * evt )
 {
   evtcnt++;
   //   int ibd = 0;
-  LL1HEADER *ll1h = new LL1HEADER();
-
-  ll1setup(evt,ll1h);
+  // decoded into the same header for every event, also the trigger thresholds
+  LL1HEADER *ll1h = &m_Decoder->Decode(evt);
 
   static int counter = 0;
   if (counter == 0)
@@ -151,46 +153,6 @@ int LL1Mon::process_event(Event * evt )
 
     h_hit_format->Fill(ll1h->hit_format_jet);
   }
-
-  Packet *pthresh = evt->getPacket(13901);
-  if (pthresh)
-    {
-      for (int ithreshold = 0; ithreshold < nthresholds; ithreshold++)
-	{
-	  std::cout << " threshold "<<ithreshold << " : " << pthresh->iValue(ithreshold) << std::endl;
-	  if (ithreshold < 4)
-	    {
-	      ll1h->jet_threshold[ithreshold] = pthresh->iValue(ithreshold);
-	    }
-	  else if (ithreshold < 8)
-	    {
-	      ll1h->photon_threshold[ithreshold - 4] = pthresh->iValue(ithreshold);
-	    }
-	  else 
-	    {
-	      ll1h->mbd_threshold[ithreshold - 8] = pthresh->iValue(ithreshold);
-	    }	  
-	}
-      delete pthresh;
-    }
-  else
-    {
-      for (int ithreshold = 0; ithreshold < nthresholds; ithreshold++)
-	{
-	  if (ithreshold < 4)
-	    {
-	      ll1h->jet_threshold[ithreshold] = ithreshold + 1;
-	    }
-	  else if (ithreshold < 8)
-	    {
-	      ll1h->photon_threshold[ithreshold - 4] = (ithreshold - 4) + 1;
-	    }
-	  else 
-	    {
-	      ll1h->mbd_threshold[ithreshold - 8] = 2;
-	    }	  
-	} 
-    }
   
   int id=3;
 
@@ -264,8 +226,6 @@ int LL1Mon::process_event(Event * evt )
 	    }
 	}
     }
-  
-  delete ll1h;
 
   return 0;
 }
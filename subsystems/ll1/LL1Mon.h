@@ -4,6 +4,7 @@
 #include <onlmon/OnlMon.h>
 
 class Event;
+class LL1Decoder;
 class TH1;
 class TH2;
 
@@ -22,6 +23,7 @@ class LL1Mon : public OnlMon
   int evtcnt = 0;
   int idummy = 0;
   int thresh=2;
+  LL1Decoder *m_Decoder=nullptr;
   TH1* h_hit_format=nullptr;
   TH2* h_line_up=nullptr;
   TH2* h_nhit_corr=nullptr;
@@ -6,15 +6,15 @@
 #include "LocalPolMon.h"
 
 #include <onlmon/OnlMon.h>  // for OnlMon
+#include <onlmon/CaloPacketDecoder.h>
 #include <onlmon/OnlMonDB.h>
+#include <onlmon/GL1Service.h>
 #include <onlmon/OnlMonServer.h>
 
 #include <Event/msg_profile.h>
-#include <caloreco/CaloWaveformFitting.h>
 
 #include <Event/Event.h>
 #include <Event/EventTypes.h>
-#include <Event/eventReceiverClient.h>
 #include <Event/msg_profile.h>
 
 #include <TH1.h>
@@ -26,6 +26,7 @@
 #include <TString.h>
 #include <TSystem.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>  // for printf
 #include <ctime>
@@ -47,6 +48,7 @@ LocalPolMon::LocalPolMon(const std::string& name)
 LocalPolMon::~LocalPolMon()
 {
   // you can delete NULL pointers it results in a NOOP (No Operation)
+  delete caloDecoder;
   return;
 }
 
@@ -136,7 +138,7 @@ int LocalPolMon::Init()
           if (ival == 1)
           {
             fake = true;
-            erc = nullptr;
+            gl1service = nullptr;
           }
           else
           {
@@ -148,15 +150,15 @@ int LocalPolMon::Init()
     else if (key == "monitoring"){
       val.ToLower();
       if (val == "online"){
-	erc = new eventReceiverClient("gl1daq");
+	gl1service = GL1Service::instance("gl1daq");
       }
       else if (val == "offline" ){
-	erc = new eventReceiverClient("localhost");
+	gl1service = GL1Service::instance("localhost");
       }
       else {
 	std::cout<< key << ": expecting either online (data stream)/offline (with eventServer -d 5263250 -s 5 -i -v -f path to gl1 prdf) "<<std::endl;
 	std::cout<<"Fall back to online monitoring"<<std::endl;
-	erc = new eventReceiverClient("gl1daq");
+	gl1service = GL1Service::instance("gl1daq");
       }
     }
     else if (key == "sphenixgap")
@@ -588,7 +590,8 @@ int LocalPolMon::Init()
   hshiftevol=new TH2D("hshiftevol","",10000,0,30000000,20,0,20);
   se->registerHisto(this,hshiftevol);
   
-  WaveformProcessingFast = new CaloWaveformFitting();
+  caloDecoder = new CaloPacketDecoder();
+  caloDecoder->SuppressedAsPrePost(false);  // fit the samples of suppressed channels as before
   myRandomBunch = new TRandom(0);
   Reset();
   return 0;
@@ -598,6 +601,10 @@ int LocalPolMon::BeginRun(const int runno)
 {
   // if you need to read calibrations on a run by run basis
   // this is the place to do it
+  if (gl1service)
+  {
+    gl1service->Reset();  // the gl1 events of the previous run are gone
+  }
 
   // Initialisation of the map (hopefully this step will not be required when gl1p scalers become available
   for (int i = 0; i < 16; i++)
@@ -623,26 +630,22 @@ int LocalPolMon::BeginRun(const int runno)
   return 0;
 }
 
-float LocalPolMon::anaWaveformFast(Packet* p, const int channel, const int low, const int high, const int ihisto)
+// fast fit of the samples [low, high) of one channel of the decoded smd packet
+float LocalPolMon::anaWaveformFast(const int channel, const int low, const int high, const int ihisto)
 {
-  std::vector<float> waveform;
-  waveform.reserve(high-low);
-  //waveform.reserve(p->iValue(0, "SAMPLES"));
-  //for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
-  for (int s = low; s < high; s++)
+  if (channel >= caloDecoder->getNChannels())
   {
-    waveform.push_back(p->iValue(s, channel));
-    hwaveform[ihisto]->Fill(s,p->iValue(s, channel));
+    return 0;
   }
-  std::vector<std::vector<float>> multiple_wfs;
-  multiple_wfs.push_back(waveform);
-
-  std::vector<std::vector<float>> fitresults_zdc;
-  fitresults_zdc = WaveformProcessingFast->calo_processing_fast(multiple_wfs);
-
-  std::vector<float> result;
-  result = fitresults_zdc.at(0);
-  return result.at(0);
+  int first = std::max(low, 0);
+  int last = std::min(high, caloDecoder->getNSamples());
+  for (int s = first; s < last; s++)
+  {
+    hwaveform[ihisto]->Fill(s, caloDecoder->getSample(channel, s));
+  }
+  CaloFastFit result;
+  caloDecoder->FitFast(channel, low, high, result);
+  return result.amplitude;
 }
 
 int LocalPolMon::process_event(Event* e /* evt */)
@@ -692,16 +695,17 @@ int LocalPolMon::process_event(Event* e /* evt */)
       bunchnr += 15 + myRandomBunch->Integer(4);
     }
 
+    caloDecoder->Decode(psmd);
     // get minimum on ZDC second module
     // get minimum on ZDC second module
-    signalZDCN1 = anaWaveformFast(psmd, ZDCN1, lowSample[ZDCN1], highSample[ZDCN1],0);
-    signalZDCS1 = anaWaveformFast(psmd, ZDCS1, lowSample[ZDCS1], highSample[ZDCS1],1);
-    signalZDCN2 = anaWaveformFast(psmd, ZDCN2, lowSample[ZDCN2], highSample[ZDCN2],0);
-    signalZDCS2 = anaWaveformFast(psmd, ZDCS2, lowSample[ZDCS2], highSample[ZDCS2],1);
-    vetoNF = anaWaveformFast(psmd, 16, lowSample[ivetoNF], highSample[ivetoNF],4);
-    vetoNB = anaWaveformFast(psmd, 17, lowSample[ivetoNB], highSample[ivetoNB],4);
-    vetoSF = anaWaveformFast(psmd, 80, lowSample[ivetoSF], highSample[ivetoSF],5);
-    vetoSB = anaWaveformFast(psmd, 81, lowSample[ivetoSB], highSample[ivetoSB],5);
+    signalZDCN1 = anaWaveformFast(ZDCN1, lowSample[ZDCN1], highSample[ZDCN1],0);
+    signalZDCS1 = anaWaveformFast(ZDCS1, lowSample[ZDCS1], highSample[ZDCS1],1);
+    signalZDCN2 = anaWaveformFast(ZDCN2, lowSample[ZDCN2], highSample[ZDCN2],0);
+    signalZDCS2 = anaWaveformFast(ZDCS2, lowSample[ZDCS2], highSample[ZDCS2],1);
+    vetoNF = anaWaveformFast(16, lowSample[ivetoNF], highSample[ivetoNF],4);
+    vetoNB = anaWaveformFast(17, lowSample[ivetoNB], highSample[ivetoNB],4);
+    vetoSF = anaWaveformFast(80, lowSample[ivetoSF], highSample[ivetoSF],5);
+    vetoSB = anaWaveformFast(81, lowSample[ivetoSB], highSample[ivetoSB],5);
 
     if ( (signalZDCN2 < 10 || signalZDCN1<75) && (signalZDCS2 < 10 || signalZDCS1<75) )
     {
@@ -722,7 +726,7 @@ int LocalPolMon::process_event(Event* e /* evt */)
       {
         continue;
       }
-      float signalFast = anaWaveformFast(psmd, it.first, lowSample[it.second],highSample[it.second],it.second/32+2);  // fast waveform fitting
+      float signalFast = anaWaveformFast(it.first, lowSample[it.second],highSample[it.second],it.second/32+2);  // fast waveform fitting
 
       int ch = it.second;
       // Scale according to relative gain calibration factor
@@ -1080,36 +1084,25 @@ void LocalPolMon::RetrieveSpinPattern(int runnb){
 }
 
 void LocalPolMon::RetrieveTriggerDistribution(Event* e){
-  Event* egl1p=nullptr;
-  Packet* pgl1p = nullptr;
-  if (erc){
-    if(verbosity){
-      std::cout<<"Inside RetrieveTrigger::ERC"<<e->getEvtSequence()<<" "<<EvtShift<<std::endl;
-    }
-    egl1p = erc->getEvent(e->getEvtSequence()+EvtShift);
-    if(verbosity){
-      std::cout<<egl1p<<std::endl;
-    }
+  GL1Data gl1p;
+  if (!gl1service){
+    return;
   }
-  if (egl1p){
-    pgl1p = egl1p->getPacket(packetid_gl1);
-    if (pgl1p){
-      int bunchnr = pgl1p->lValue(0, "BunchNumber");
-      for (int i=0; i<16; i++){//auto& i : gl1_counter)
-	// 16 triggers for gl1p
-	// With prdf pgl1->lValue(i,2); simply returns the current processed event number (which can shaddow the abort gap: the lagging bunch# at some point get back to the position of the others)
-	// So instead, we increment the number of processed events per bunch number, for the various triggers
-	//gl1_counter[i][bunchnr]+= (pgl1p->lValue(i,2)>0)?1:0;
-	if(pgl1p->lValue(i,2)>0){
-	  gl1_counter[i][bunchnr]++;
-	  h_trigger[i]->Fill(bunchnr);
-	}
+  if(verbosity){
+    std::cout<<"Inside RetrieveTrigger::GL1Service"<<e->getEvtSequence()<<" "<<EvtShift<<std::endl;
+  }
+  if (gl1service->getGL1Data(e->getEvtSequence()+EvtShift, gl1p) == 0){
+    int bunchnr = gl1p.bunchnumber;
+    for (int i=0; i<16; i++){//auto& i : gl1_counter)
+      // 16 triggers for gl1p
+      // With prdf pgl1->lValue(i,2); simply returns the current processed event number (which can shaddow the abort gap: the lagging bunch# at some point get back to the position of the others)
+      // So instead, we increment the number of processed events per bunch number, for the various triggers
+      //gl1_counter[i][bunchnr]+= (gl1p.gl1pscaler[i]>0)?1:0;
+      if(gl1p.gl1pscaler[i]>0){
+	gl1_counter[i][bunchnr]++;
+	h_trigger[i]->Fill(bunchnr);
       }
-      delete pgl1p;
-      pgl1p=nullptr;
     }
-    delete egl1p;
-    egl1p=nullptr;
   }
 }
 
@@ -1155,7 +1148,6 @@ int LocalPolMon::RetrieveAbortGapData(){
 
 
 int LocalPolMon::RetrieveBunchNumber(Event* e, long long int zdc_clock){
-  Event* egl1 = nullptr;
   int bunch=-1;
   //static int localfail=0;
   if(!Initfirstbunch){
@@ -1176,25 +1168,22 @@ int LocalPolMon::RetrieveBunchNumber(Event* e, long long int zdc_clock){
     return -1;
   }
   //std::cout<<e->getEvtSequence()<<std::endl;
-  if (erc){
-    if(verbosity){
-      std::cout<<"Inside RetrieveBunchNumber::ERC "<<e->getEvtSequence() <<" "<<EvtShift <<std::endl;
-    }
-    egl1 = erc->getEvent(e->getEvtSequence()+EvtShift);
+  GL1Data gl1p;
+  if (gl1service){
     if(verbosity){
-      std::cout<<egl1<<std::endl;
+      std::cout<<"Inside RetrieveBunchNumber::GL1Service "<<e->getEvtSequence() <<" "<<EvtShift <<std::endl;
     }
+    gl1service->getGL1Data(e->getEvtSequence()+EvtShift, gl1p);
   }
-  if (egl1){
+  if (gl1p.haveevent){
     if(verbosity){
       std::cout<<"Inside RetrieveBunchNumber::GL1"<<std::endl;
     }
-    Packet* pgl1p = egl1->getPacket(packetid_gl1);
-    if (pgl1p){
+    if (gl1p.havepacket){
       if(verbosity){
 	std::cout<<"Inside RetrieveBunchNumber::PGL1p"<<std::endl;
       }
-      long long int gl1_clock=pgl1p->lValue(0, "BCO");
+      long long int gl1_clock=gl1p.bco;
       if(verbosity){
        std::cout<<"EvtShift: "<<EvtShift<<" zdc: "<<zdc_clock<<"    gl1p: "<<gl1_clock<<std::endl;
       }
@@ -1202,14 +1191,10 @@ int LocalPolMon::RetrieveBunchNumber(Event* e, long long int zdc_clock){
       if(!Initfirstbunch){
 	Prevgl1_clock=gl1_clock;
 	Initfirstbunch=true;
-	bunch = pgl1p->lValue(0, "BunchNumber");
+	bunch = gl1p.bunchnumber;
 	if(verbosity){
 	  std::cout<<"Init Bunch number is : "<<bunch<<std::endl;
 	}
-	delete pgl1p;
-	pgl1p=nullptr;
-	delete egl1;
-	egl1=nullptr;
 	return bunch;
       }
       if(zdc_clock<Prevzdc_clock){
@@ -1229,10 +1214,6 @@ int LocalPolMon::RetrieveBunchNumber(Event* e, long long int zdc_clock){
 	//  exit(1) ;
 	//}
 	EvtShift++;
-	delete pgl1p;
-	pgl1p=nullptr;
-	delete egl1;
-	egl1=nullptr;
 	failuredepth++;
 	hsyncfrac->Fill(0.);
 	hevolsync->Fill(e->getEvtSequence(),0);
@@ -1248,22 +1229,18 @@ int LocalPolMon::RetrieveBunchNumber(Event* e, long long int zdc_clock){
 	hsyncfrac->Fill(1.);
 	hevolsync->Fill(e->getEvtSequence(),1);
 	hshiftevol->Fill(e->getEvtSequence(),EvtShift);
-	bunch = pgl1p->lValue(0, "BunchNumber");
+	bunch = gl1p.bunchnumber;
 	//failuredepth=0;
 	if(verbosity){
 	  std::cout<<"Bunch number is : "<<bunch<<std::endl;
 	}
       }
-      delete pgl1p;
-      pgl1p = nullptr;
     }
     else{
       if (verbosity){
 	std::cout << "Failed grabing gl1 from event receiver, Bunch number unknown" << std::endl;
       }
     }
-    delete egl1;
-    egl1 = nullptr;
   }
   return bunch;
 }
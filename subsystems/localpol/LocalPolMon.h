@@ -7,7 +7,7 @@
 #include <map>
 #include <vector>
 
-class CaloWaveformFitting;
+class CaloPacketDecoder;
 class Event;
 class TH1D;
 class TH2I;
@@ -15,7 +15,7 @@ class TH2D;
 class TProfile;
 class Packet;
 class TRandom;
-class eventReceiverClient;
+class GL1Service;
 
 class LocalPolMon : public OnlMon
 {
@@ -30,15 +30,14 @@ class LocalPolMon : public OnlMon
 
  private:
   double *ComputeAsymmetries(double L_U, double R_D, double L_D, double R_U);
-  float anaWaveformFast(Packet *p, const int channel, const int low, const int high, const int ihisto);
-  CaloWaveformFitting *WaveformProcessingFast = nullptr;
+  float anaWaveformFast(const int channel, const int low, const int high, const int ihisto);
+  CaloPacketDecoder *caloDecoder = nullptr;
   void RetrieveSpinPattern(int r);
   void RetrieveTriggerDistribution(Event* e);
   int RetrieveAbortGapData();
   int RetrieveBunchNumber(Event* e, long long int z);
   bool GoodSelection(int i);
 
-  const int packetid_gl1 = 14001;  // could be ported to config
   const int packetid_smd = 12001;  // could be ported to config
 
   const int UP = 1;
@@ -138,7 +137,7 @@ class LocalPolMon : public OnlMon
   
   TRandom *myRandomBunch = nullptr;
   //std::map<int, int> stored_gl1p_files;
-  eventReceiverClient *erc = nullptr;
+  GL1Service *gl1service = nullptr;  // shared, not owned
 };
 
 #endif /* LOCALPOL_LOCALPOLMON_H */
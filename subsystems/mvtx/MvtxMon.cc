@@ -12,6 +12,7 @@
 
 #include <onlmon/OnlMon.h>  // for OnlMon
 #include <onlmon/OnlMonDB.h>
+#include <onlmon/OnlMonHistory.h>
 #include <onlmon/OnlMonServer.h>
 
 #include <Event/msg_profile.h>
@@ -572,10 +573,7 @@ int MvtxMon::process_event(Event* evt)
     delete plist[i];
   }
 
-  for(int bin = 1; bin < 50 ; bin ++){
-    hErrorPlotsTime->SetBinContent(bin,hErrorPlotsTime->GetBinContent(bin+1));
-  }
-  hErrorPlotsTime->SetBinContent(50,nDecError);
+  OnlMonHistory::Fill(hErrorPlotsTime, nDecError);
 
 
   int firedChips = 0;
@@ -2,6 +2,7 @@
 
 #include <onlmon/OnlMonClient.h>
 #include <onlmon/OnlMonDB.h>
+#include <onlmon/OnlMonHistory.h>
 
 #include <TAxis.h>  // for TAxis
 #include <TCanvas.h>
@@ -23,6 +24,7 @@
 #include <TText.h>
 #include <TExec.h>
 
+#include <bitset>
 #include <cstring>  // for memset
 #include <ctime>
 #include <fstream>
@@ -46,6 +48,44 @@ MvtxMonDraw::MvtxMonDraw(const std::string &name)
 
 int MvtxMonDraw::Init()
 {
+  // the pages show the sums over the FELIX servers, read from the aggregator if it runs
+  const char *general[] = {"FEE_LaneStatus_Overview_FlagPROBLEM", "MVTXMON_General_Occupancy", "MVTXMON_General_Noisy_Pixel",
+                           "General_DecErrors", "General_hfeeStrobes", "General_feeL1", "General_DecErrorsEndpoint",
+                           "OCC_ChipStave1D", "hStrobesDMA", "hDMAstatus"};
+  for (auto hname : general)
+  {
+    AddMergedCanvasHisto("GENERAL", hname);
+  }
+  AddCanvasHisto("GENERAL", "General_DecErrorsTime");  // not added up by the aggregator
+  const char *fee[] = {"FHR_ErrorVsFeeid", "General_DecErrors", "General_DecErrorsEndpoint", "RDHErrors_hfeeRDHErrors"};
+  for (auto hname : fee)
+  {
+    AddMergedCanvasHisto("FEE", hname);
+  }
+  for (int i = 0; i < NFlags; i++)
+  {
+    AddMergedCanvasHisto("FEE", Form("FEE_LaneStatus_Flag_%s", mLaneStatusFlag[i].c_str()));
+    AddMergedCanvasHisto("FEE", Form("FEE_LaneStatusFromSOX_Flag_%s", mLaneStatusFlag[i].c_str()));
+  }
+  const char *occ[] = {"OCC_ChipStave1D", "OCC_ChipFiredFLX", "General_hChipStrobes", "General_ChipL1"};
+  for (auto hname : occ)
+  {
+    AddMergedCanvasHisto("OCC", hname);
+  }
+  const char *fhr[] = {"MVTXMON_General_ErrorVsFeeid", "MVTXMON_General_Occupancy", "MVTXMON_General_Noisy_Pixel",
+                       "MVTXMON_Occupancy_TotalDeadChipPos", "OCC_HitChipPerStrobe", "OCC_HitFLXPerStrobe"};
+  for (auto hname : fhr)
+  {
+    AddMergedCanvasHisto("FHR", hname);
+  }
+  AddCanvasHisto("FHR", "RCDAQ_evt");
+  for (int aLayer = 0; aLayer < NLAYERS; aLayer++)
+  {
+    AddMergedCanvasHisto("OCC", Form("OCC_Occupancy1D_Layer%d", aLayer));
+    AddMergedCanvasHisto("OCC", Form("OCC_OccupancyChipStave_Layer_%d", aLayer));
+    AddMergedCanvasHisto("FHR", Form("MVTXMON_Occupancy_Layer%d_Layer%dDeadChipPos", aLayer, aLayer));
+    AddCanvasHisto("FHR", Form("FHR_NoisyChipStave_Layer%d", aLayer));  // normalized per server with RCDAQ_evt
+  }
   return 0;
 }
 
@@ -444,6 +484,7 @@ int MvtxMonDraw::DrawGeneral(const std::string & /* what */)
     mGeneralNoisyPixel[iFelix] = dynamic_cast<TH2Poly *>(cl->getHisto(Form("MVTXMON_%d", iFelix), "MVTXMON_General_Noisy_Pixel"));
     mvtxmon_mGeneralErrorPlots[iFelix] = dynamic_cast<TH1D *>(cl->getHisto(Form("MVTXMON_%d", iFelix), "General_DecErrors"));
     mvtxmon_mGeneralErrorPlotsTime[iFelix] = dynamic_cast<TH1D *>(cl->getHisto(Form("MVTXMON_%d", iFelix), "General_DecErrorsTime"));
+    OnlMonHistory::Unroll(mvtxmon_mGeneralErrorPlotsTime[iFelix]);  // ring buffer to time order
     hChipStrobes[iFelix] = dynamic_cast<TH1I *>(cl->getHisto(Form("MVTXMON_%d", iFelix), "General_hfeeStrobes"));
     hChipL1[iFelix] = dynamic_cast<TH1I *>(cl->getHisto(Form("MVTXMON_%d", iFelix), "General_feeL1"));
     mvtxmon_mGeneralErrorFile[iFelix] = dynamic_cast<TH2D *>(cl->getHisto(Form("MVTXMON_%d", iFelix), "General_DecErrorsEndpoint"));
@@ -461,37 +502,37 @@ int MvtxMonDraw::DrawGeneral(const std::string & /* what */)
   int bitset = 0;
   int bitsetOR = 0;
   int bitsetAND = 63;
-  bitset = MergeServers<TH2Poly *>(mvtxmon_LaneStatusOverview);
+  bitset = MergeServers<TH2Poly *>(mvtxmon_LaneStatusOverview, "FEE_LaneStatus_Overview_FlagPROBLEM");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH2Poly *>(mvtxmon_mGeneralOccupancy);
+  bitset = MergeServers<TH2Poly *>(mvtxmon_mGeneralOccupancy, "MVTXMON_General_Occupancy");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH2Poly *>(mGeneralNoisyPixel);
+  bitset = MergeServers<TH2Poly *>(mGeneralNoisyPixel, "MVTXMON_General_Noisy_Pixel");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH1D *>(mvtxmon_mGeneralErrorPlots);
+  bitset = MergeServers<TH1D *>(mvtxmon_mGeneralErrorPlots, "General_DecErrors");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
   bitset = MergeServers<TH1D *>(mvtxmon_mGeneralErrorPlotsTime);
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH1I *>(hChipStrobes);
+  bitset = MergeServers<TH1I *>(hChipStrobes, "General_hfeeStrobes");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH1I *>(hChipL1);
+  bitset = MergeServers<TH1I *>(hChipL1, "General_feeL1");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH2D *>(mvtxmon_mGeneralErrorFile);
+  bitset = MergeServers<TH2D *>(mvtxmon_mGeneralErrorFile, "General_DecErrorsEndpoint");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH1D *>(mvtxmon_ChipStave1D);
+  bitset = MergeServers<TH1D *>(mvtxmon_ChipStave1D, "OCC_ChipStave1D");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH1I *>(hStrobesDMA);
+  bitset = MergeServers<TH1I *>(hStrobesDMA, "hStrobesDMA");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
-  bitset = MergeServers<TH1I *>(hDMAstatus);
+  bitset = MergeServers<TH1I *>(hDMAstatus, "hDMAstatus");
   bitsetOR |= bitset;
   bitsetAND &= bitset;
 
@@ -982,17 +1023,17 @@ int MvtxMonDraw::DrawFEE(const std::string & /* what */)
 
   for (int i = 0; i < 3; i++)
   {
-    MergeServers<TH2I *>(mLaneStatus[i]);
-    MergeServers<TH2I *>(mLaneStatusCumulative[i]);
+    MergeServers<TH2I *>(mLaneStatus[i], Form("FEE_LaneStatus_Flag_%s", mLaneStatusFlag[i].c_str()));
+    MergeServers<TH2I *>(mLaneStatusCumulative[i], Form("FEE_LaneStatusFromSOX_Flag_%s", mLaneStatusFlag[i].c_str()));
     //MergeServers<TH1I *>(mLaneStatusSummary[i]);
   }
   //MergeServers<TH2I *>(mTriggerVsFeeId);
   //MergeServers<TH1I *>(mTrigger);
   // MergeServers<TH2I*>(mLaneInfo);
-  MergeServers<TH2I *>(FHR_ErrorVsFeeid);
-    MergeServers<TH1D *>(mvtxmon_mGeneralErrorPlots);
-      MergeServers<TH2D *>(mvtxmon_mGeneralErrorFile);
-  MergeServers<TH1I *>(hRDHErrors);
+  MergeServers<TH2I *>(FHR_ErrorVsFeeid, "FHR_ErrorVsFeeid");
+    MergeServers<TH1D *>(mvtxmon_mGeneralErrorPlots, "General_DecErrors");
+      MergeServers<TH2D *>(mvtxmon_mGeneralErrorFile, "General_DecErrorsEndpoint");
+  MergeServers<TH1I *>(hRDHErrors, "RDHErrors_hfeeRDHErrors");
 
   if (!gROOT->FindObject("MvtxMon_FEE"))
   {
@@ -1160,8 +1201,8 @@ int MvtxMonDraw::DrawOCC(const std::string & /* what */)
 
   for (int i = 0; i < 3; i++)
   {
-    MergeServers<TH1D *>(hOccupancyPlot[i]);
-    MergeServers<TH2D *>(hChipStaveOccupancy[i]);
+    MergeServers<TH1D *>(hOccupancyPlot[i], Form("OCC_Occupancy1D_Layer%d", i));
+    MergeServers<TH2D *>(hChipStaveOccupancy[i], Form("OCC_OccupancyChipStave_Layer_%d", i));
   }
 
   TH2D *hChipStaveOccupancy_low[3] = {nullptr};
@@ -1194,10 +1235,10 @@ int MvtxMonDraw::DrawOCC(const std::string & /* what */)
     }
   }
 
-  MergeServers<TH1D *>(mvtxmon_ChipStave1D);
-  MergeServers<TH1D *>(mvtxmon_ChipFiredHis);
-  MergeServers<TH1I *>(hChipStrobes);
-  MergeServers<TH1I *>(hChipL1);
+  MergeServers<TH1D *>(mvtxmon_ChipStave1D, "OCC_ChipStave1D");
+  MergeServers<TH1D *>(mvtxmon_ChipFiredHis, "OCC_ChipFiredFLX");
+  MergeServers<TH1I *>(hChipStrobes, "General_hChipStrobes");
+  MergeServers<TH1I *>(hChipL1, "General_ChipL1");
 
   if (mvtxmon_ChipStave1D[NFlx])
   {
@@ -1375,10 +1416,6 @@ int MvtxMonDraw::DrawFHR(const std::string & /* what */)
     for (int mLayer = 0; mLayer < 3; mLayer++)
     {
       mDeadChipPos[mLayer][iFelix] = dynamic_cast<TH2D *>(cl->getHisto(Form("MVTXMON_%d", iFelix), Form("MVTXMON_Occupancy_Layer%d_Layer%dDeadChipPos", mLayer, mLayer)));
-      if (mDeadChipPos[mLayer][iFelix])
-      {
-        nFLX[mLayer]++;
-      }
       //mAliveChipPos[mLayer][iFelix] = dynamic_cast<TH2D *>(cl->getHisto(Form("MVTXMON_%d", iFelix), Form("MVTXMON_Occupancy_Layer%d_Layer%dAliveChipPos", mLayer, mLayer)));
       // mChipStaveOccupancy[mLayer][iFelix] =  dynamic_cast<TH2D*>(cl->getHisto(Form("MVTXMON/Occupancy/Layer%d/Layer%dChipStaveC", mLayer, mLayer)));
 
@@ -1404,9 +1441,10 @@ int MvtxMonDraw::DrawFHR(const std::string & /* what */)
 
   for (int mLayer = 0; mLayer < 3; mLayer++)
   {
-    MergeServers<TH2D *>(mDeadChipPos[mLayer]);
+    // number of servers in the sum, their dead chip maps are 1 outside of their staves
+    nFLX[mLayer] = std::bitset<NFlx>(MergeServers<TH2D *>(mDeadChipPos[mLayer], Form("MVTXMON_Occupancy_Layer%d_Layer%dDeadChipPos", mLayer, mLayer))).count();
     //MergeServers<TH2D *>(mAliveChipPos[mLayer]);
-    MergeServers<TH2D *>(mChipStaveNoisy[mLayer]);
+    MergeServers<TH2D *>(mChipStaveNoisy[mLayer]);  // normalized per server above
     if (mDeadChipPos[mLayer][NFlx])
     {
       mDeadChipPos[mLayer][NFlx]->SetMinimum(0);
@@ -1418,13 +1456,13 @@ int MvtxMonDraw::DrawFHR(const std::string & /* what */)
     }*/
   }
 
-  MergeServers<TH2I *>(mErrorVsFeeid);
-  MergeServers<TH2Poly *>(mGeneralOccupancy);
-  MergeServers<TH2Poly *>(mGeneralNoisyPixel);
-  MergeServers<TH2D *>(mTotalDeadChipPos);
+  MergeServers<TH2I *>(mErrorVsFeeid, "MVTXMON_General_ErrorVsFeeid");
+  MergeServers<TH2Poly *>(mGeneralOccupancy, "MVTXMON_General_Occupancy");
+  MergeServers<TH2Poly *>(mGeneralNoisyPixel, "MVTXMON_General_Noisy_Pixel");
+  MergeServers<TH2D *>(mTotalDeadChipPos, "MVTXMON_Occupancy_TotalDeadChipPos");
   //MergeServers<TH2D *>(mTotalAliveChipPos);
-  MergeServers<TH1D *>(mvtxmon_EvtHitChip);
-  MergeServers<TH1D *>(mvtxmon_EvtHitDis);
+  MergeServers<TH1D *>(mvtxmon_EvtHitChip, "OCC_HitChipPerStrobe");
+  MergeServers<TH1D *>(mvtxmon_EvtHitDis, "OCC_HitFLXPerStrobe");
   MergeServers<TH1I *>(mRCDAQevt);
 
   if (mTotalDeadChipPos[NFlx])
@@ -1789,10 +1827,29 @@ int MvtxMonDraw::PublishHistogram(TPad *p, TH1 *h, const char *opt, int palettes
 }
 
 template <typename T>
-int MvtxMonDraw::MergeServers(T *h)
+int MvtxMonDraw::MergeServers(T *h, const std::string &hname)
 {
   bool cloned = false;
   unsigned int bitset = 0;
+  OnlMonClient *cl = OnlMonClient::instance();
+  if (!hname.empty() && !Aggregator().empty())
+  {
+    // the servers do not send their copies of hname while the aggregator serves the sum,
+    // whoever still sends its FrameWorkVars is alive
+    T merged = dynamic_cast<T>(cl->getHisto(Aggregator(), hname));
+    if (merged)
+    {
+      h[NFlx] = dynamic_cast<T>(merged->Clone());
+      for (unsigned int iFelix = 0; iFelix < NFlx; iFelix++)
+      {
+        if (cl->getHisto(Form("MVTXMON_%d", iFelix), "FrameWorkVars"))
+        {
+          bitset |= (1U << (iFelix));
+        }
+      }
+      return bitset;
+    }
+  }
   for (unsigned int iFelix = 0; iFelix < NFlx; iFelix++)
   {
     if (cloned == false)
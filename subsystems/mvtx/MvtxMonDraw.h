@@ -41,8 +41,9 @@ class MvtxMonDraw : public OnlMonDraw
   // int PublishHistogram(TPad *p, int pad, T h, const char* opt = "");
   int PublishHistogram(TPad *p, int pad, TH1 *h, const char *opt = "", int palettestyle=0);
   void PublishStatistics(int canvasid, OnlMonClient *cl);
+  // sum of h[0..NFlx-1] into h[NFlx], taken from the aggregator if it serves hname
   template <typename T>
-  int MergeServers(T *h);
+  int MergeServers(T *h, const std::string &hname = "");
   void formatPaveText(TPaveText *aPT, float aTextSize, Color_t aTextColor, short aTextAlign, const char *aText);
   std::vector<Quality> analyseForError(TH2Poly *lane, TH2Poly *noisy, TH1 *strobes, TH1 *decErr, TH1 *decErrTime, TH1 *DMAstat);
   void DrawPave(std::vector<MvtxMonDraw::Quality> status, int position, const char *what = "");
@@ -5,11 +5,15 @@
 #include <odbc++/connection.h>
 #include <odbc++/drivermanager.h>
 #include <odbc++/errorhandler.h>
+#include <odbc++/preparedstatement.h>
 #include <odbc++/resultset.h>
 #include <odbc++/resultsetmetadata.h>
 #include <odbc++/setup.h>
+#include <odbc++/statement.h>
 #include <odbc++/types.h>
 #include <sql.h>
+#include <sqlext.h>
+#include <sqlite3.h>
 #include <iostream>
 
 #include <algorithm>
@@ -21,166 +25,414 @@
 
 static odbc::Connection* con = nullptr;
 
+namespace
+{
+  const unsigned int GRANULELEN = 32;  // varchar size of the granule column
+  const int SQLITETIMEOUT = 10000;  // ms to wait for a locked sqlite file
+
+  bool odbcCheck(const SQLRETURN ret, const SQLSMALLINT handletype, SQLHANDLE handle, const std::string& what)
+  {
+    if (SQL_SUCCEEDED(ret))
+    {
+      return true;
+    }
+    std::cout << "ODBC error executing " << what << std::endl;
+    SQLCHAR state[6];
+    SQLCHAR message[SQL_MAX_MESSAGE_LENGTH];
+    SQLINTEGER nativeerror;
+    SQLSMALLINT len;
+    for (SQLSMALLINT i = 1; SQLGetDiagRec(handletype, handle, i, state, &nativeerror, message, sizeof(message), &len) == SQL_SUCCESS; i++)
+    {
+      std::cout << "Message: " << message << std::endl;
+    }
+    return false;
+  }
+
+  bool sqliteCheck(const int ret, sqlite3* db, const std::string& what)
+  {
+    if (ret == SQLITE_OK || ret == SQLITE_DONE || ret == SQLITE_ROW)
+    {
+      return true;
+    }
+    std::cout << "sqlite error executing " << what << std::endl;
+    std::cout << "Message: " << sqlite3_errmsg(db) << std::endl;
+    return false;
+  }
+}  // namespace
+
 PktSizeDBodbc::PktSizeDBodbc(const std::string& name)
   : OnlMonBase(name)
   , tableprefix(name)
 {
+  packettable = tableprefix + "packets";
+  // table names are lower case only
+  transform(packettable.begin(), packettable.end(), packettable.begin(), (int (*)(int)) tolower);
 }
 
 PktSizeDBodbc::~PktSizeDBodbc()
 {
+  {
+    std::lock_guard<std::mutex> lock(queuemutex);
+    stopwriter = true;
+  }
+  queuecond.notify_all();
+  if (writer.joinable())
+  {
+    writer.join();  // the queued runs are still written
+  }
+  CloseWriterConnection();
   delete con;
   con = nullptr;
 }
 
-int PktSizeDBodbc::CheckAndCreateTable(const std::string& name, const std::map<unsigned int, unsigned int>& packetsize)
+void PktSizeDBodbc::SetDB(const std::string& name, const std::string& owner, const std::string& passwd)
 {
-  if (GetConnection())
+  static const std::string sqliteprefix = "sqlite:";
+  if (name.compare(0, sqliteprefix.size(), sqliteprefix) == 0)
   {
-    return -1;
+    sqlitefile = name.substr(sqliteprefix.size());
+    dbname.clear();
   }
+  else
+  {
+    sqlitefile.clear();
+    dbname = name;
+  }
+  dbowner = owner;
+  dbpasswd = passwd;
+  return;
+}
+
+int PktSizeDBodbc::AddRun(const int runnumber, const int nevnts, const std::vector<PacketRow>& rows)
+{
+  std::lock_guard<std::mutex> lock(queuemutex);
+  if (!writer.joinable())
+  {
+    writer = std::thread(&PktSizeDBodbc::WriterLoop, this);
+  }
+  RunEntry run;
+  run.runnumber = runnumber;
+  run.nevnts = nevnts;
+  run.rows = rows;
+  runqueue.push_back(std::move(run));
+  queuecond.notify_all();
+  return 0;
+}
+
+void PktSizeDBodbc::Flush()
+{
+  std::unique_lock<std::mutex> lock(queuemutex);
+  queuecond.wait(lock, [this] { return runqueue.empty() && !writing; });
+  return;
+}
+
+void PktSizeDBodbc::WriterLoop()
+{
+  std::unique_lock<std::mutex> lock(queuemutex);
+  while (true)
+  {
+    queuecond.wait(lock, [this] { return stopwriter || !runqueue.empty(); });
+    if (runqueue.empty())
+    {
+      break;  // stop requested and nothing left to write
+    }
+    RunEntry run = std::move(runqueue.front());
+    runqueue.pop_front();
+    writing = true;
+    lock.unlock();
+    WriteRun(run);
+    lock.lock();
+    writing = false;
+    queuecond.notify_all();
+  }
+  return;
+}
 
-  // Postgres version
-  // std::cout << con->getMetaData()-> getDatabaseProductVersion() << std::endl;
-  odbc::Statement* stmt = con->createStatement();
+std::string PktSizeDBodbc::CreateTableCommand() const
+{
   std::ostringstream cmd;
-  //  cmd << "SELECT COUNT(*) FROM " << name << " WHERE 1 = 2" ;
-  // cmd << "select " << name << " from pg_tables where schemaname='public";
-  std::string lowname = name;
-  // The bizarre cast here is needed for newer gccs
-  transform(lowname.begin(), lowname.end(), lowname.begin(), (int (*)(int)) tolower);
-  cmd << "select * from pg_tables where tablename = '" << lowname << "'";
-  //  cmd << "SELECT * FROM " << name << " LIMIT 1" ;
+  cmd << "CREATE TABLE IF NOT EXISTS " << packettable
+      << " (runnumber int NOT NULL, granule varchar(" << GRANULELEN << ") NOT NULL, packet int NOT NULL,"
+      << " bytes float NOT NULL, events int NOT NULL, primary key(runnumber, packet))";
   if (verbosity > 0)
   {
-    std::cout << "cmd: " << cmd.str() << std::endl;
+    std::cout << "Executing " << cmd.str() << std::endl;
   }
+  return cmd.str();
+}
 
-  odbc::ResultSet* rs = nullptr;
-  try
+bool PktSizeDBodbc::KeepExistingRun(const RunEntry& run, const int events) const
+{
+  if (run.nevnts > events)
   {
-    rs = stmt->executeQuery(cmd.str());
+    return false;
   }
-  catch (odbc::SQLException& e)
+  std::cout << "Run " << run.runnumber << " already in table "
+            << packettable << " extracted from " << events << " Events"
+            << std::endl;
+  std::cout << "Run more events than " << events
+            << " if you want to overwrite this entry" << std::endl;
+  return true;
+}
+
+int PktSizeDBodbc::WriteRun(const RunEntry& run)
+{
+  int iret = (sqlitefile.empty()) ? WriteRunOdbc(run) : WriteRunSqlite(run);
+  if (verbosity > 0 && iret == 0)
   {
-    std::cout << name << " does not exist, creating it" << std::endl;
+    std::cout << "wrote " << run.rows.size() << " packets of run " << run.runnumber
+              << " to " << packettable << std::endl;
   }
-  int iret = 0;
+  return iret;
+}
 
-  cmd.str("");
-  if (!rs->next())
+int PktSizeDBodbc::WriteRunOdbc(const RunEntry& run)
+{
+  if (GetWriterConnection())
   {
-    delete rs;
-    rs = nullptr;
-    cmd << "CREATE TABLE " << name << "(runnumber int NOT NULL, events int NOT NULL";
-    std::map<unsigned int, unsigned int>::const_iterator iter;
-    for (iter = packetsize.begin(); iter != packetsize.end(); ++iter)
+    return -1;
+  }
+  SQLHSTMT stmt = SQL_NULL_HSTMT;
+  if (!odbcCheck(SQLAllocHandle(SQL_HANDLE_STMT, writerdbc, &stmt), SQL_HANDLE_DBC, writerdbc, "SQLAllocHandle"))
+  {
+    return -1;
+  }
+  if (!tablechecked)
+  {
+    std::string cmd = CreateTableCommand();
+    if (!odbcCheck(SQLExecDirect(stmt, (SQLCHAR*) cmd.c_str(), SQL_NTS), SQL_HANDLE_STMT, stmt, cmd))
     {
-      cmd << ", p_" << iter->first << " float DEFAULT 0";
+      SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+      return -1;
     }
-    cmd << ", primary key(runnumber))";
-    if (verbosity > 0)
+    tablechecked = true;
+  }
+
+  // check if an entry for this run exists already
+  SQLINTEGER runnumber = run.runnumber;
+  SQLINTEGER events = 0;
+  SQLLEN eventsind = SQL_NULL_DATA;
+  std::string cmd = "SELECT max(events) FROM " + packettable + " WHERE runnumber = ?";
+  if (!odbcCheck(SQLPrepare(stmt, (SQLCHAR*) cmd.c_str(), SQL_NTS), SQL_HANDLE_STMT, stmt, cmd) ||
+      !odbcCheck(SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &runnumber, 0, nullptr), SQL_HANDLE_STMT, stmt, cmd) ||
+      !odbcCheck(SQLExecute(stmt), SQL_HANDLE_STMT, stmt, cmd) ||
+      !odbcCheck(SQLBindCol(stmt, 1, SQL_C_SLONG, &events, 0, &eventsind), SQL_HANDLE_STMT, stmt, cmd))
+  {
+    SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+    return -1;
+  }
+  bool found = SQL_SUCCEEDED(SQLFetch(stmt)) && eventsind != SQL_NULL_DATA;
+  SQLCloseCursor(stmt);
+  SQLFreeStmt(stmt, SQL_UNBIND);
+  if (found && KeepExistingRun(run, events))
+  {
+    SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+    return 0;
+  }
+
+  // the rows as parameter arrays (one per column), all packets go in with one execution
+  SQLULEN nrows = (run.nevnts > 0) ? run.rows.size() : 0;
+  std::vector<SQLINTEGER> runnumbers(nrows, run.runnumber);
+  std::vector<SQLCHAR> granules(nrows * GRANULELEN, 0);
+  std::vector<SQLLEN> granulelens(nrows, 0);
+  std::vector<SQLINTEGER> packets(nrows, 0);
+  std::vector<SQLREAL> bytes(nrows, 0);
+  std::vector<SQLINTEGER> nevents(nrows, run.nevnts);
+  for (SQLULEN i = 0; i < nrows; i++)
+  {
+    const PacketRow& row = run.rows[i];
+    granulelens[i] = std::min<SQLLEN>(row.granule.size(), GRANULELEN);
+    std::copy(row.granule.begin(), row.granule.begin() + granulelens[i], granules.begin() + i * GRANULELEN);
+    packets[i] = row.packet;
+    bytes[i] = (float) (row.size) / (float) (run.nevnts);
+    bytes[i] *= 4;  // convert from 32 bit words to bytes
+  }
+
+  // replace the run in one transaction
+  SQLSetConnectAttr(writerdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, 0);
+  cmd = "DELETE FROM " + packettable + " WHERE runnumber = ?";
+  bool ok = odbcCheck(SQLPrepare(stmt, (SQLCHAR*) cmd.c_str(), SQL_NTS), SQL_HANDLE_STMT, stmt, cmd) &&
+            odbcCheck(SQLExecute(stmt), SQL_HANDLE_STMT, stmt, cmd);  // runnumber is still bound
+  SQLFreeStmt(stmt, SQL_RESET_PARAMS);
+  if (ok && nrows > 0)
+  {
+    cmd = "INSERT INTO " + packettable + " (runnumber, granule, packet, bytes, events) VALUES (?, ?, ?, ?, ?)";
+    ok = odbcCheck(SQLPrepare(stmt, (SQLCHAR*) cmd.c_str(), SQL_NTS), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLSetStmtAttr(stmt, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLSetStmtAttr(stmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) nrows, 0), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, runnumbers.data(), 0, nullptr), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLBindParameter(stmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, GRANULELEN, 0, granules.data(), GRANULELEN, granulelens.data()), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLBindParameter(stmt, 3, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, packets.data(), 0, nullptr), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLBindParameter(stmt, 4, SQL_PARAM_INPUT, SQL_C_FLOAT, SQL_REAL, 0, 0, bytes.data(), 0, nullptr), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLBindParameter(stmt, 5, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, nevents.data(), 0, nullptr), SQL_HANDLE_STMT, stmt, cmd) &&
+         odbcCheck(SQLExecute(stmt), SQL_HANDLE_STMT, stmt, cmd);
+  }
+  SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+  ok = odbcCheck(SQLEndTran(SQL_HANDLE_DBC, writerdbc, (ok) ? SQL_COMMIT : SQL_ROLLBACK), SQL_HANDLE_DBC, writerdbc, "SQLEndTran") && ok;
+  SQLSetConnectAttr(writerdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_ON, 0);
+  return (ok) ? 0 : -1;
+}
+
+int PktSizeDBodbc::WriteRunSqlite(const RunEntry& run)
+{
+  if (!sqlitewriter)
+  {
+    if (sqlite3_open_v2(sqlitefile.c_str(), &sqlitewriter, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK)
     {
-      std::cout << "Executing " << cmd.str() << std::endl;
+      std::cout << PHWHERE << " cannot open " << sqlitefile << ": " << sqlite3_errmsg(sqlitewriter) << std::endl;
+      sqlite3_close(sqlitewriter);
+      sqlitewriter = nullptr;
+      return -1;
     }
-    try
+    sqlite3_busy_timeout(sqlitewriter, SQLITETIMEOUT);
+  }
+  if (!tablechecked)
+  {
+    if (!sqliteCheck(sqlite3_exec(sqlitewriter, CreateTableCommand().c_str(), nullptr, nullptr, nullptr), sqlitewriter, "CREATE TABLE"))
     {
-      iret = stmt->executeUpdate(cmd.str());
+      return -1;
     }
-    catch (odbc::SQLException& e)
+    tablechecked = true;
+  }
+
+  // check if an entry for this run exists already
+  sqlite3_stmt* stmt = nullptr;
+  std::string cmd = "SELECT max(events) FROM " + packettable + " WHERE runnumber = ?";
+  if (!sqliteCheck(sqlite3_prepare_v2(sqlitewriter, cmd.c_str(), -1, &stmt, nullptr), sqlitewriter, cmd))
+  {
+    return -1;
+  }
+  sqlite3_bind_int(stmt, 1, run.runnumber);
+  bool found = (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL);
+  int events = (found) ? sqlite3_column_int(stmt, 0) : 0;
+  sqlite3_finalize(stmt);
+  if (found && KeepExistingRun(run, events))
+  {
+    return 0;
+  }
+
+  // replace the run in one transaction, the insert is prepared once and executed per packet
+  bool ok = sqliteCheck(sqlite3_exec(sqlitewriter, "BEGIN", nullptr, nullptr, nullptr), sqlitewriter, "BEGIN");
+  cmd = "DELETE FROM " + packettable + " WHERE runnumber = ?";
+  ok = ok && sqliteCheck(sqlite3_prepare_v2(sqlitewriter, cmd.c_str(), -1, &stmt, nullptr), sqlitewriter, cmd);
+  if (ok)
+  {
+    sqlite3_bind_int(stmt, 1, run.runnumber);
+    ok = sqliteCheck(sqlite3_step(stmt), sqlitewriter, cmd);
+    sqlite3_finalize(stmt);
+  }
+  if (ok && !run.rows.empty() && run.nevnts > 0)
+  {
+    cmd = "INSERT INTO " + packettable + " (runnumber, granule, packet, bytes, events) VALUES (?, ?, ?, ?, ?)";
+    ok = sqliteCheck(sqlite3_prepare_v2(sqlitewriter, cmd.c_str(), -1, &stmt, nullptr), sqlitewriter, cmd);
+    for (auto iter = run.rows.begin(); ok && iter != run.rows.end(); ++iter)
     {
-      std::cout << "Exception caught, Message: " << e.getMessage() << std::endl;
+      float size_in_bytes = (float) (iter->size) / (float) (run.nevnts);
+      size_in_bytes *= 4;  // convert from 32 bit words to bytes
+      sqlite3_bind_int(stmt, 1, run.runnumber);
+      sqlite3_bind_text(stmt, 2, iter->granule.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int(stmt, 3, iter->packet);
+      sqlite3_bind_double(stmt, 4, size_in_bytes);
+      sqlite3_bind_int(stmt, 5, run.nevnts);
+      ok = sqliteCheck(sqlite3_step(stmt), sqlitewriter, cmd);
+      sqlite3_reset(stmt);
     }
+    sqlite3_finalize(stmt);
   }
-  delete stmt;
-  return iret;
+  const char* endtran = (ok) ? "COMMIT" : "ROLLBACK";
+  ok = sqliteCheck(sqlite3_exec(sqlitewriter, endtran, nullptr, nullptr, nullptr), sqlitewriter, endtran) && ok;
+  return (ok) ? 0 : -1;
 }
 
-int PktSizeDBodbc::AddRow(const std::string& granulename, const int runnumber, const int nevnts, const std::map<unsigned int, unsigned int>& packetsize)
+int PktSizeDBodbc::GetPacketContent(std::map<unsigned int, float>& packetsize, const int runnumber, const std::string& granulename)
 {
-  std::string table = tableprefix + granulename;
-
-  CheckAndCreateTable(table, packetsize);
-
-  int iret = 0;
-  std::ostringstream cmd;
-
+  if (!sqlitefile.empty())
+  {
+    return GetPacketContentSqlite(packetsize, runnumber, granulename);
+  }
   if (GetConnection())
   {
     return -1;
   }
+  std::string cmd = "SELECT packet, bytes FROM " + packettable + " WHERE runnumber = ? AND granule = ?";
 
-  odbc::Statement* stmt = con->createStatement();
+  if (verbosity > 0)
+  {
+    std::cout << "command: " << cmd << " (" << runnumber << ", " << granulename << ")" << std::endl;
+  }
 
-  // check if an entry for this run exists already
-  cmd << "SELECT events FROM " << table << " where runnumber = "
-      << runnumber;
-  odbc::ResultSet* rs;
+  odbc::PreparedStatement* query = nullptr;
+  odbc::ResultSet* rs = nullptr;
   try
   {
-    rs = stmt->executeQuery(cmd.str());
+    query = con->prepareStatement(cmd);
+    query->setInt(1, runnumber);
+    query->setString(2, granulename);
+    rs = query->executeQuery();
   }
-  catch (odbc::SQLException& e)
+  catch (odbc::SQLException&)
   {
-    std::cout << "Exception caught, Message: " << e.getMessage() << std::endl;
-    return -1;
+    // no long format table yet
+    delete query;
+    return GetPacketContentGranuleTable(packetsize, runnumber, granulename);
   }
-  if (rs->next())
+  int nfound = 0;
+  while (rs->next())
   {
-    int events = rs->getInt("events");
-    if (nevnts <= events)
-    {
-      std::cout << "Run " << runnumber << " already in table "
-           << table << " extracted from " << events << " Events"
-           << std::endl;
-      std::cout << "Run more events than " << events
-           << " if you want to overwrite this entry" << std::endl;
-      delete rs;
-      return 0;
-    }
-    else
+    nfound++;
+    unsigned int ipkt = rs->getInt(1);
+    float size = rs->getFloat(2);
+    if (rs->wasNull() || size <= 1.)
     {
-      cmd.str("");
-      cmd << "DELETE FROM " << table << " WHERE runnumber = " << runnumber;
-      odbc::Statement* stmt2 = con->createStatement();
-      stmt2->executeUpdate(cmd.str());
+      continue;
     }
+    packetsize[ipkt] = size / 4.;  // convert from bytes to long words
   }
   delete rs;
-  // update columns in table in case there is a new packet
-  CheckAndAddColumns(table, packetsize);
-
-  // now add the content
-  std::map<unsigned int, unsigned int>::const_iterator iter;
-  cmd.str("");
-  std::ostringstream cmd1, cmd2;
-  cmd1 << "INSERT INTO " << table
-       << " (runnumber, events";
-  cmd2 << " VALUES(" << runnumber << ", " << nevnts;
-  float size_in_bytes;
-  for (iter = packetsize.begin(); iter != packetsize.end(); ++iter)
-  {
-    cmd1 << ", p_" << iter->first;
-    size_in_bytes = (float) (iter->second) / (float) (nevnts);
-    size_in_bytes *= 4;  // convert from 32 bit words to bytes
-    cmd2 << ", " << size_in_bytes;
-  }
-  cmd1 << ")";
-  cmd2 << ")";
-  cmd << cmd1.str() << cmd2.str();
-  try
+  delete query;
+  if (nfound == 0)
   {
-    stmt->executeUpdate(cmd.str());
+    return GetPacketContentGranuleTable(packetsize, runnumber, granulename);
   }
-  catch (odbc::SQLException& e)
+  return 0;
+}
+
+int PktSizeDBodbc::GetPacketContentSqlite(std::map<unsigned int, float>& packetsize, const int runnumber, const std::string& granulename)
+{
+  // the writer thread has its own connection
+  sqlite3* db = nullptr;
+  if (sqlite3_open_v2(sqlitefile.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
   {
-    std::cout << "Exception caught, Message: " << e.getMessage() << std::endl;
+    std::cout << PHWHERE << " cannot open " << sqlitefile << ": " << sqlite3_errmsg(db) << std::endl;
+    sqlite3_close(db);
+    return -1;
   }
-
-  return iret;
+  sqlite3_busy_timeout(db, SQLITETIMEOUT);
+  std::string cmd = "SELECT packet, bytes FROM " + packettable + " WHERE runnumber = ? AND granule = ?";
+  sqlite3_stmt* stmt = nullptr;
+  if (!sqliteCheck(sqlite3_prepare_v2(db, cmd.c_str(), -1, &stmt, nullptr), db, cmd))
+  {
+    sqlite3_close(db);
+    return -1;
+  }
+  sqlite3_bind_int(stmt, 1, runnumber);
+  sqlite3_bind_text(stmt, 2, granulename.c_str(), -1, SQLITE_TRANSIENT);
+  while (sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    unsigned int ipkt = sqlite3_column_int(stmt, 0);
+    float size = sqlite3_column_double(stmt, 1);
+    if (sqlite3_column_type(stmt, 1) == SQLITE_NULL || size <= 1.)
+    {
+      continue;
+    }
+    packetsize[ipkt] = size / 4.;  // convert from bytes to long words
+  }
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+  return 0;
 }
 
-int PktSizeDBodbc::GetPacketContent(std::map<unsigned int, float>& packetsize, const int runnumber, const std::string& granulename)
+int PktSizeDBodbc::GetPacketContentGranuleTable(std::map<unsigned int, float>& packetsize, const int runnumber, const std::string& granulename)
 {
   if (GetConnection())
   {
@@ -265,62 +517,54 @@ int PktSizeDBodbc::GetConnection()
   return 0;
 }
 
-int PktSizeDBodbc::CheckAndAddColumns(const std::string& table, const std::map<unsigned int, unsigned int>& packetsize)
+int PktSizeDBodbc::GetWriterConnection()
 {
-  if (GetConnection())
+  if (writerdbc != SQL_NULL_HDBC)
   {
-    return -1;
+    return 0;
   }
-  odbc::Statement* stmt = con->createStatement();
-  std::ostringstream cmd;
-  cmd << "SELECT * FROM " << table << " limit 1 ";
-  odbc::ResultSet* rs;
-  try
+  if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &writerenv)))
   {
-    rs = stmt->executeQuery(cmd.str());
+    std::cout << PHWHERE << " cannot allocate odbc environment" << std::endl;
+    writerenv = SQL_NULL_HENV;
+    return -1;
   }
-  catch (odbc::SQLException& e)
+  SQLSetEnvAttr(writerenv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER) SQL_OV_ODBC3, 0);
+  if (!odbcCheck(SQLAllocHandle(SQL_HANDLE_DBC, writerenv, &writerdbc), SQL_HANDLE_ENV, writerenv, "SQLAllocHandle"))
   {
-    std::cout << "Exception caught, Message: " << e.getMessage() << std::endl;
+    writerdbc = SQL_NULL_HDBC;
+    CloseWriterConnection();
     return -1;
   }
-  std::map<unsigned int, unsigned int>::const_iterator iter;
-  std::set<unsigned int> packetids;
-  for (iter = packetsize.begin(); iter != packetsize.end(); ++iter)
+  if (!odbcCheck(SQLConnect(writerdbc, (SQLCHAR*) dbname.c_str(), SQL_NTS,
+                            (SQLCHAR*) dbowner.c_str(), SQL_NTS,
+                            (SQLCHAR*) dbpasswd.c_str(), SQL_NTS),
+                 SQL_HANDLE_DBC, writerdbc, "SQLConnect to " + dbname))
   {
-    packetids.insert(iter->first);
+    SQLFreeHandle(SQL_HANDLE_DBC, writerdbc);
+    writerdbc = SQL_NULL_HDBC;
+    CloseWriterConnection();
+    return -1;
   }
-  for (int i = 1; i <= rs->getMetaData()->getColumnCount(); i++)
+  std::cout << "opened DB writer connection" << std::endl;
+  return 0;
+}
+
+void PktSizeDBodbc::CloseWriterConnection()
+{
+  if (writerdbc != SQL_NULL_HDBC)
   {
-    std::string colname = rs->getMetaData()->getColumnName(i);
-    if (colname == "runnumber" || colname == "events")
-    {
-      continue;
-    }
-    std::string packet = colname.substr(colname.find_last_of('_') + 1);
-    std::istringstream istr(packet);
-    unsigned int ipkt;
-    istr >> ipkt;
-    packetids.erase(ipkt);
+    SQLDisconnect(writerdbc);
+    SQLFreeHandle(SQL_HANDLE_DBC, writerdbc);
+    writerdbc = SQL_NULL_HDBC;
   }
-  delete rs;
-  std::set<unsigned int>::const_iterator siter;
-  for (siter = packetids.begin(); siter != packetids.end(); ++siter)
-  {
-    std::ostringstream newcol;
-    newcol.str("");
-    newcol << "p_" << *siter;
-    cmd.str("");
-    cmd << "ALTER TABLE " << table << " ADD COLUMN " << newcol.str()
-        << " float DEFAULT 0";
-    try
-    {
-      stmt->executeUpdate(cmd.str());
-    }
-    catch (odbc::SQLException& e)
-    {
-      std::cout << "Exception caught, Message: " << e.getMessage() << std::endl;
-    }
+  if (writerenv != SQL_NULL_HENV)
+  {
+    SQLFreeHandle(SQL_HANDLE_ENV, writerenv);
+    writerenv = SQL_NULL_HENV;
   }
-  return 0;
+  sqlite3_close(sqlitewriter);
+  sqlitewriter = nullptr;
+  tablechecked = false;
+  return;
 }
@@ -3,27 +3,94 @@
 
 #include <onlmon/OnlMonBase.h>
 
+#include <sql.h>
+
+#include <condition_variable>
 #include <ctime>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+// Packet sizes are stored in one long format table <name>packets with
+// one row per (run, packet): granule, average size in bytes and the
+// number of events. The schema does not depend on the packets which were
+// seen, a run is written in a transaction with a single execution of a
+// prepared insert (the rows are bound as parameter arrays). The writes
+// are done by a worker thread on its own connection, AddRun() only
+// queues the run.
+// SetDB("sqlite:<file>") stores the table in a local sqlite file instead
+// of the odbc dsn, for testing without the production database.
+
+struct sqlite3;
+
 class PktSizeDBodbc : public OnlMonBase
 {
  public:
+  struct PacketRow
+  {
+    std::string granule;
+    unsigned int packet{0};
+    unsigned int size{0};  // summed over all events, in 32 bit words
+  };
+
   PktSizeDBodbc(const std::string &name);
   virtual ~PktSizeDBodbc();
-  int CheckAndCreateTable(const std::string &name, const std::map<unsigned int, unsigned int> &packetsize);
-  int CheckAndAddColumns(const std::string &table, const std::map<unsigned int, unsigned int> &packetsize);
-  int AddRow(const std::string &granulename, const int runnumber, const int nevnts, const std::map<unsigned int, unsigned int> &packetsize);
-  int GetPacketContent(std::map<unsigned int, float> &packetsize, const int runnumber, const std::string &table);
+
+  // delete copy ctor and assignment operator (cppcheck)
+  explicit PktSizeDBodbc(const PktSizeDBodbc &) = delete;
+  PktSizeDBodbc &operator=(const PktSizeDBodbc &) = delete;
+
+  // odbc dsn or sqlite:<file>, to be set before the first AddRun()
+  void SetDB(const std::string &name, const std::string &owner = "", const std::string &passwd = "");
+  // queue the packets of a run for the writer thread
+  int AddRun(const int runnumber, const int nevnts, const std::vector<PacketRow> &rows);
+  // wait until all queued runs are written
+  void Flush();
+  int GetPacketContent(std::map<unsigned int, float> &packetsize, const int runnumber, const std::string &granulename);
 
  private:
+  struct RunEntry
+  {
+    int runnumber{0};
+    int nevnts{0};
+    std::vector<PacketRow> rows;
+  };
+
   int GetConnection();
+  int GetWriterConnection();
+  void CloseWriterConnection();
+  std::string CreateTableCommand() const;
+  bool KeepExistingRun(const RunEntry &run, const int events) const;
+  int WriteRun(const RunEntry &run);
+  int WriteRunOdbc(const RunEntry &run);
+  int WriteRunSqlite(const RunEntry &run);
+  void WriterLoop();
+  int GetPacketContentSqlite(std::map<unsigned int, float> &packetsize, const int runnumber, const std::string &granulename);
+  // runs before the long format table was introduced (one table per granule, one column per packet)
+  int GetPacketContentGranuleTable(std::map<unsigned int, float> &packetsize, const int runnumber, const std::string &granulename);
+
   std::string dbname;
   std::string dbowner;
   std::string dbpasswd;
+  std::string sqlitefile;
   std::string tableprefix;
+  std::string packettable;
+  bool tablechecked{false};
+
+  // owned by the writer thread
+  SQLHENV writerenv{SQL_NULL_HENV};
+  SQLHDBC writerdbc{SQL_NULL_HDBC};
+  sqlite3 *sqlitewriter{nullptr};
+
+  std::thread writer;
+  std::mutex queuemutex;
+  std::condition_variable queuecond;
+  std::deque<RunEntry> runqueue;
+  bool writing{false};
+  bool stopwriter{false};
 };
 
 #endif
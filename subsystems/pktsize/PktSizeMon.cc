@@ -12,6 +12,7 @@
 
 #include <TH1.h>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -52,12 +53,28 @@ int PktSizeMon::Init()
   PktSizeCommon::fillgranules(granulepacketlimits);
   PktSizeCommon::filldcmgroups(dcmgroups);
   PktSizeCommon::fillfibergroups(fibergroups);
+  // dense packet id -> slot table covering all granules and dcm groups
+  unsigned int maxpacket = 0;
+  for (auto &graniter : granulepacketlimits)
+  {
+    maxpacket = std::max(maxpacket, graniter.second.second);
+  }
+  for (auto &dcmiter : dcmgroups)
+  {
+    maxpacket = std::max(maxpacket, dcmiter.first);
+  }
+  packetslot.assign(maxpacket + 1, -1);
   return 0;
 }
 
 int PktSizeMon::Reset()
 {
   packetsize.clear();
+  std::fill(packetslot.begin(), packetslot.end(), -1);
+  overflowslot.clear();
+  slotpacket.clear();
+  slotsize.clear();
+  ndataevnts = 0;
 
   OnlMonServer *se = OnlMonServer::instance();
   TH1 *newhist = new TH1F("pktsize_tmp", "packet size storage facility", 1, 0, 1);
@@ -74,6 +91,10 @@ int PktSizeMon::process_event(Event *e)
   {
     return 0;
   }
+  if (ndataevnts++ % sampling != 0)
+  {
+    return 0;
+  }
   int nw = e->getPacketList(plist, 10000);
   if (nw >= 10000)
   {
@@ -83,28 +104,34 @@ int PktSizeMon::process_event(Event *e)
     se->send_message(this, MSG_SOURCE_DAQMON, MSG_SEV_ERROR, errmsg.str(), 1);
     nw = 10000;
   }
-  int packetid;
-  unsigned int size;
-  std::map<unsigned int, unsigned int>::iterator mapiter;
   for (int i = 0; i < nw; i++)
   {
-    packetid = plist[i]->getIdentifier();
-    size = (plist[i]->getLength());
-    packetsize[packetid] += size;
-    //      std::string dcmgrp = dcmgroups[packetid];
-    //      dcmgroupsize[dcmgrp] += size;
-    //       mapiter = packetsize.find(packetid);
-    //       if (mapiter != packetsize.end())
-    //         {
-    //           mapiter->second += size;
-    //         }
-    //       else
-    //         {
-    //           packetsize[packetid] = size;
-    //         }
-    std::cout << "Packet " << packetid << " size: " << size << " sum size: "
-	      << packetsize[packetid] << std::endl;
+    unsigned int packetid = plist[i]->getIdentifier();
+    unsigned int size = plist[i]->getLength();
     delete plist[i];
+    int slot;
+    if (packetid < packetslot.size())
+    {
+      slot = packetslot[packetid];
+      if (slot < 0)
+      {
+        slot = packetslot[packetid] = slotpacket.size();
+        slotpacket.push_back(packetid);
+        slotsize.push_back(0);
+      }
+    }
+    else
+    {
+      auto iter = overflowslot.find(packetid);
+      if (iter == overflowslot.end())
+      {
+        iter = overflowslot.insert(std::make_pair(packetid, slotpacket.size())).first;
+        slotpacket.push_back(packetid);
+        slotsize.push_back(0);
+      }
+      slot = iter->second;
+    }
+    slotsize[slot] += size;
   }
   nevnts++;
   if (nevnts % NUPDATE == 0)
@@ -118,6 +145,15 @@ int PktSizeMon::process_event(Event *e)
   return 0;
 }
 
+void PktSizeMon::syncmap()
+{
+  for (unsigned int slot = 0; slot < slotpacket.size(); slot++)
+  {
+    packetsize[slotpacket[slot]] = slotsize[slot];
+  }
+  return;
+}
+
 int PktSizeMon::EndRun(const int runno)
 {
   putmapinhisto();
@@ -128,6 +164,7 @@ int PktSizeMon::EndRun(const int runno)
 int PktSizeMon::putmapinhisto()
 {
   OnlMonServer *se = OnlMonServer::instance();
+  syncmap();
   if (packetsize.size() != (unsigned int) sizehist->GetNbinsX())
   {
     TH1 *newhist = new TH1F("pktsize_tmp", "packet size storage facility", packetsize.size(), 0, packetsize.size());
@@ -151,6 +188,7 @@ int PktSizeMon::putmapinhisto()
 
 void PktSizeMon::Print(const std::string &what)
 {
+  syncmap();
   if (what == "ALL")
   {
     std::map<unsigned int, unsigned int>::const_iterator mapiter;
@@ -254,10 +292,11 @@ void PktSizeMon::Print(const std::string &what)
 
 int PktSizeMon::UpdateDB(const int runno)
 {
+  syncmap();
   std::map<std::string, std::pair<unsigned int, unsigned int> >::const_iterator graniter;
   std::string name;
   unsigned int lolim, hilim;
-  std::map<unsigned int, unsigned int> granpackets;
+  std::vector<PktSizeDBodbc::PacketRow> rows;  // all granules go in with one insert
   std::map<unsigned int, unsigned int>::iterator piter0, piter1, piter2;
   for (graniter = granulepacketlimits.begin(); graniter != granulepacketlimits.end(); ++graniter)
   {
@@ -265,7 +304,7 @@ int PktSizeMon::UpdateDB(const int runno)
     lolim = graniter->second.first;
     hilim = graniter->second.second;
     piter1 = packetsize.lower_bound(lolim);
-    if (piter1->first < hilim)
+    if (piter1 != packetsize.end() && piter1->first <= hilim)
     {
       if (verbosity > 0)
       {
@@ -285,11 +324,9 @@ int PktSizeMon::UpdateDB(const int runno)
     }
     for (piter0 = piter1; piter0 != packetsize.upper_bound(hilim); ++piter0)
     {
-      granpackets[piter0->first] = piter0->second;
+      rows.push_back({name, piter0->first, piter0->second});
     }
-    db->AddRow(name, runno, nevnts, granpackets);
     packetsize.erase(packetsize.lower_bound(lolim), packetsize.upper_bound(hilim));
-    granpackets.clear();
   }
   if (packetsize.size() > 0)
   {
@@ -306,8 +343,18 @@ int PktSizeMon::UpdateDB(const int runno)
     }
     OnlMonServer *se = OnlMonServer::instance();
     se->send_message(this, MSG_SOURCE_DAQMON, MSG_SEV_ERROR, errmsg.str(), 2);
-    db->AddRow("nogran", runno, nevnts, packetsize);
+    for (piter0 = packetsize.begin(); piter0 != packetsize.end(); ++piter0)
+    {
+      rows.push_back({"nogran", piter0->first, piter0->second});
+    }
   }
+  // written by the db writer thread, we do not wait for it
+  db->AddRun(runno, nevnts, rows);
   packetsize.clear();
+  // the sums went into the db, start over
+  std::fill(packetslot.begin(), packetslot.end(), -1);
+  overflowslot.clear();
+  slotpacket.clear();
+  slotsize.clear();
   return 0;
 }
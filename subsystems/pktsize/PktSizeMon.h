@@ -5,6 +5,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 class Event;
 class Packet;
@@ -24,14 +25,24 @@ class PktSizeMon : public OnlMon
   void Print(const std::string &what = "ALL");
   int UpdateDB(const int runno = 0);
   //  virtual void Verbosity(const int i);
+  // only every n-th data event is accumulated (averages stay per event), default 1 (all)
+  void SetSampling(const int n) { sampling = (n > 0) ? n : 1; }
 
  protected:
   int putmapinhisto();
+  void syncmap();
   int nevnts;
+  int sampling = 1;
+  int ndataevnts = 0;
   TH1 *sizehist = nullptr;
   Packet *plist[10000]{};
   PktSizeDBodbc *db;
-  std::map<unsigned int, unsigned int> packetsize;
+  std::map<unsigned int, unsigned int> packetsize;  // filled from the slots by syncmap()
+  // per event accumulator: packet id -> slot (-1 not seen yet), ids above the granule limits go to overflowslot
+  std::vector<int> packetslot;
+  std::map<unsigned int, int> overflowslot;
+  std::vector<unsigned int> slotpacket;
+  std::vector<unsigned int> slotsize;
   std::map<std::string, std::pair<unsigned int, unsigned int> > granulepacketlimits;
   std::map<unsigned int, std::string> dcmgroups;
   std::map<std::string, unsigned int> dcmgroupsize;
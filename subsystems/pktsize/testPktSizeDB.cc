@@ -0,0 +1,84 @@
+// writes runs with PktSizeDBodbc into a sqlite file and reads them back,
+// run by make check
+
+#include "PktSizeDBodbc.h"
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+  int nfailed = 0;
+
+  void check(const bool ok, const std::string &what)
+  {
+    std::cout << ((ok) ? "ok     " : "FAILED ") << what << std::endl;
+    if (!ok)
+    {
+      nfailed++;
+    }
+  }
+
+  bool same(const float a, const float b)
+  {
+    return std::fabs(a - b) < 1e-3;
+  }
+}  // namespace
+
+int main()
+{
+  std::string dbfile = "testpktsizedb_" + std::to_string(getpid()) + ".sqlite";
+  std::map<unsigned int, float> pkts;
+  {
+    PktSizeDBodbc db("PKTSIZEMON");
+    db.SetDB("sqlite:" + dbfile);
+    std::vector<PktSizeDBodbc::PacketRow> rows;
+    rows.push_back({"gl1", 14001, 4000});
+    rows.push_back({"seb00", 6001, 2000});
+    rows.push_back({"seb00", 6002, 1000});
+    check(db.AddRun(100, 10, rows) == 0, "queue run 100");
+    db.Flush();
+    check(db.GetPacketContent(pkts, 100, "seb00") == 0, "read run 100");
+    check(pkts.size() == 2 && same(pkts[6001], 200) && same(pkts[6002], 100), "packets of seb00 in run 100");
+
+    // fewer events do not overwrite the run
+    rows[0].size = 10000;
+    db.AddRun(100, 5, rows);
+    db.Flush();
+    pkts.clear();
+    db.GetPacketContent(pkts, 100, "gl1");
+    check(pkts.size() == 1 && same(pkts[14001], 400), "run 100 kept with fewer events");
+
+    // more events replace all packets of the run
+    rows.pop_back();
+    db.AddRun(100, 20, rows);
+    db.Flush();
+    pkts.clear();
+    db.GetPacketContent(pkts, 100, "gl1");
+    check(pkts.size() == 1 && same(pkts[14001], 500), "run 100 replaced with more events");
+    pkts.clear();
+    db.GetPacketContent(pkts, 100, "seb00");
+    check(pkts.size() == 1 && same(pkts[6001], 100), "dropped packet removed from run 100");
+
+    // still queued when the db goes away, written by the destructor
+    db.AddRun(101, 1, rows);
+  }
+  {
+    PktSizeDBodbc db("PKTSIZEMON");
+    db.SetDB("sqlite:" + dbfile);
+    pkts.clear();
+    db.GetPacketContent(pkts, 101, "gl1");
+    check(pkts.size() == 1 && same(pkts[14001], 10000), "run 101 written at destruction");
+    pkts.clear();
+    db.GetPacketContent(pkts, 101, "seb01");
+    check(pkts.empty(), "no packets for unknown granule");
+  }
+  remove(dbfile.c_str());
+  return (nfailed == 0) ? 0 : 1;
+}
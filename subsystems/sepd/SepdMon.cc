@@ -6,6 +6,7 @@
 #include "SepdMon.h"
 
 #include <onlmon/OnlMon.h>  // for OnlMon
+#include <onlmon/CaloPacketDecoder.h>
 #include <onlmon/OnlMonDB.h>
 #include <onlmon/OnlMonServer.h>
 #include <onlmon/pseudoRunningMean.h>
@@ -59,6 +60,8 @@ SepdMon::~SepdMon()
   {
     delete iter;
   }
+  delete caloDecoder;
+  delete WaveformProcessingTemp;
   return;
 }
 
@@ -147,7 +150,8 @@ int SepdMon::Init()
   }
 
   // initialize waveform extraction tool
-  WaveformProcessingFast = new CaloWaveformFitting();
+  caloDecoder = new CaloPacketDecoder();
+  caloDecoder->SuppressedAsPrePost(false);  // fit the samples of suppressed channels as before
 
   WaveformProcessingTemp = new CaloWaveformFitting();
 
@@ -216,25 +220,6 @@ std::vector<float> SepdMon::getSignal(Packet *p, const int channel)
   return result;
 }
 
-std::vector<float> SepdMon::anaWaveformFast(Packet *p, const int channel)
-{
-  std::vector<float> waveform;
-  for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
-  {
-    waveform.push_back(p->iValue(s, channel));
-  }
-  std::vector<std::vector<float>> multiple_wfs;
-  multiple_wfs.push_back(waveform);
-
-  std::vector<std::vector<float>> fitresults_sepd;
-  fitresults_sepd = WaveformProcessingFast->calo_processing_fast(multiple_wfs);
-
-  std::vector<float> result;
-  result = fitresults_sepd.at(0);
-
-  return result;
-}
-
 std::vector<float> SepdMon::anaWaveformTemp(Packet *p, const int channel)
 {
   std::vector<float> waveform;
@@ -282,18 +267,21 @@ int SepdMon::process_event(Event *e /* evt */)
       h1_packet_length->SetBinContent(packet_bin, rm_packet_length[packet - packetlow]->getMean(0));
 
       h1_packet_event->SetBinContent(packet - packetlow + 1, p->lValue(0, "CLOCK"));
-      int nPacketChannels = p->iValue(0, "CHANNELS");
+      int nPacketChannels = caloDecoder->Decode(p);
       if (nPacketChannels > m_nChannels)
       {
+        delete p;
         return -1;  // packet is corrupted, reports too many channels
       }
+      int nSamples = caloDecoder->getNSamples();
+      caloDecoder->FitFast();  // fast waveform fitting of the whole packet
       // else
       // {
       //   rm_packet_chans[packet - packetlow]->Add(&nChannels);
       //   h1_packet_chans->SetBinContent(packet_bin, rm_packet_chans[packet - packetlow]->getMean(0));
       // }
       int channel_counter = 0;
-      for (int c = 0; c < p->iValue(0, "CHANNELS"); c++)
+      for (int c = 0; c < nPacketChannels; c++)
       {
         // msg << "Filling channel: " << c << " for packet: " << packet << std::endl;
         // se->send_message(this, MSG_SOURCE_UNSPECIFIED, MSG_SEV_INFORMATIONAL, msg.str(), TRGMESSAGE);
@@ -311,10 +299,10 @@ int SepdMon::process_event(Event *e /* evt */)
         if ( reject_this_channel ) continue;
 
         // std::vector result =  getSignal(p,c); // simple peak extraction
-        std::vector<float> resultFast = anaWaveformFast(p, c);  // fast waveform fitting
-        float signalFast = resultFast.at(0);
-        float timeFast = resultFast.at(1);
-        float pedestalFast = resultFast.at(2);
+        const CaloFastFit &resultFast = caloDecoder->getFit(c);
+        float signalFast = resultFast.amplitude;
+        float timeFast = resultFast.time;
+        float pedestalFast = resultFast.pedestal;
 
         bool is_good_hit = ( signalFast > 50 && signalFast < 3000 );
 
@@ -324,9 +312,10 @@ int SepdMon::process_event(Event *e /* evt */)
         // float pedestalTemp = resultTemp.at(2);
         if (signalFast > hit_threshold)
         {
-          for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
+          const float *waveform = caloDecoder->getWaveform(c);
+          for (int s = 0; s < nSamples; s++)
           {
-            h2_sepd_waveform->Fill(s, p->iValue(s, c) - pedestalFast);
+            h2_sepd_waveform->Fill(s, waveform[s] - pedestalFast);
           }
         }
         // ---
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <vector>
 
+class CaloPacketDecoder;
 class CaloWaveformFitting;
 class TowerInfoContainer;
 class Event;
@@ -26,7 +27,6 @@ class SepdMon : public OnlMon
 
  protected:
   std::vector<float> getSignal(Packet *p, const int channel);
-  std::vector<float> anaWaveformFast(Packet *p, const int channel);
   std::vector<float> anaWaveformTemp(Packet *p, const int channel);
   int evtcnt = 0;
   int idummy = 0;
@@ -73,7 +73,7 @@ class SepdMon : public OnlMon
   std::string runtypestr = "Unknown";
   std::string id_string;
 
-  CaloWaveformFitting *WaveformProcessingFast = nullptr;
+  CaloPacketDecoder *caloDecoder = nullptr;
   CaloWaveformFitting *WaveformProcessingTemp = nullptr;
 
   std::vector<runningMean *> rm_packet_number;
@@ -13,7 +13,6 @@
 
 #include <Event/Event.h>
 #include <Event/EventTypes.h>
-#include <Event/eventReceiverClient.h>
 #include <Event/msg_profile.h>
 
 #include <TH1.h>
@@ -129,8 +128,6 @@ int SpinMon::Init()
 
   Reset();
 
-  erc = new eventReceiverClient("gl1daq");
-
   return 0;
 }
 
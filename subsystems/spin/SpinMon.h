@@ -7,7 +7,6 @@ class Event;
 class TH1;
 class TH2;
 class Packet;
-class eventReceiverClient;
 
 class SpinMon : public OnlMon
 {
@@ -65,7 +64,6 @@ class SpinMon : public OnlMon
 
   int CalculateCrossingShift(int &xingshift, uint64_t counts[NTRIG][NBUNCHES], bool &success);
 
-  eventReceiverClient *erc = {nullptr};
 
   const int BLUE = 0;
   const int YELLOW = 1;
@@ -7,6 +7,7 @@
 
 #include <onlmon/OnlMon.h>  // for OnlMon
 #include <onlmon/OnlMonDB.h>
+#include <onlmon/OnlMonEventCounter.h>
 #include <onlmon/OnlMonServer.h>
 
 #include <Event/Event.h>
@@ -73,6 +74,9 @@ int TpcMon::Init()
   // use printf for stuff which should go the screen but not into the message
   // system (all couts are redirected)
   printf("doing the Init\n");
+
+  // the sector is known by now (SetMonitorServerId() comes before registerMonitor())
+  BuildGeometry();
   //TPC GEM Module Displays
   NorthSideADC = new TH2F("NorthSideADC" , "ADC Counts North Side", N_thBins, -TMath::Pi()/12. , 23.*TMath::Pi()/12. , N_rBins , rBin_edges );
   SouthSideADC = new TH2F("SouthSideADC" , "ADC Counts South Side", N_thBins, -TMath::Pi()/12. , 23.*TMath::Pi()/12. , N_rBins , rBin_edges );
@@ -659,14 +663,8 @@ int TpcMon::Init()
 
   char NStreakers_vs_Event_title_str[256];
   sprintf(NStreakers_vs_Event_title_str,"Number of Streakers vs Event, Sector # %i",MonitorServerId());
-  NStreaks_vs_EventNo = new TH1F("NStreaks_vs_EventNo",NStreakers_vs_Event_title_str, 1000000, -0.5, 999999.5 );
-  NStreaks_vs_EventNo->SetXTitle("Event #");
-  NStreaks_vs_EventNo->SetYTitle("Number of horizontal streak channels");
-  NStreaks_vs_EventNo -> GetXaxis() -> SetLabelSize(0.05);
-  NStreaks_vs_EventNo -> GetXaxis() -> SetTitleSize(0.05);
-  NStreaks_vs_EventNo -> GetYaxis() -> SetLabelSize(0.05);
-  NStreaks_vs_EventNo -> GetYaxis() -> SetTitleSize(0.05);
-  NStreaks_vs_EventNo -> GetYaxis() -> SetTitleOffset(1.0);
+  // sparse (event #, streak channels) pairs, no limit on the event #, TpcMonDraw renders it
+  NStreaks_vs_EventNo = OnlMonEventCounter::Book("NStreaks_vs_EventNo",NStreakers_vs_Event_title_str);
 
   char NEvents_vs_EBDC_title_str[256];
   sprintf(NEvents_vs_EBDC_title_str,"N_{Events} vs EBDC");
@@ -911,6 +909,10 @@ int TpcMon::process_event(Event *evt/* evt */)
         int checksumError = p->iValue(wf, "CHECKSUMERROR");
         int parityError = p->iValue(wf, "DATAPARITYERROR");
         int channel = p->iValue(wf, "CHANNEL");
+        if (fee < 0 || fee >= N_FEE || channel < 0 || channel >= N_CHANNEL)
+        {
+          continue; // corrupt fee/channel, no mapping or geometry for it
+        }
 
         if( p->iValue(wf,"TYPE")!=0 ){
           Check_Sums->Fill(FEE_transform[fee]*8 + sampaAddress); 
@@ -924,52 +926,10 @@ int TpcMon::process_event(Event *evt/* evt */)
         sample_size_hist->Fill(nr_Samples);
 
 
-        // clockwise FEE mapping
-        //int FEE_map[26]={5, 6, 1, 3, 2, 12, 10, 11, 9, 8, 7, 1, 2, 4, 8, 7, 6, 5, 4, 3, 1, 3, 2, 4, 6, 5};
-        int FEE_R[26]={2, 2, 1, 1, 1, 3, 3, 3, 3, 3, 3, 2, 2, 1, 2, 2, 1, 1, 2, 2, 3, 3, 3, 3, 3, 3};
-        // counter clockwise FEE mapping (From Takao - DEPRECATED AS OF 08.29)
-        //int FEE_map[26]={3, 2, 5, 3, 4, 0, 2, 1, 3, 4, 5, 7, 6, 2, 0, 1, 0, 1, 4, 5, 11, 9, 10, 8, 6, 7};
-
-        // FEE mapping from Jin
-        int FEE_map[26]={4, 5, 0, 2, 1, 11, 9, 10, 8, 7, 6, 0, 1, 3, 7, 6, 5, 4, 3, 2, 0, 2, 1, 3, 5, 4};
-
-        
-        //int pads_per_sector[3] = {96, 128, 192};
-
-
-        serverid = MonitorServerId();
-
-        // setting the mapp of the FEE
-        int feeM = FEE_map[fee];
-        if(FEE_R[fee]==2) feeM += 6;
-        if(FEE_R[fee]==3) feeM += 14;
-
-        // getting R and Phi coordinates
-        double R = M.getR(feeM, channel);
-        double padphi = 0;
-
-        if( side(serverid) == 0 ) //NS
-        {
-          padphi =  M.getPad(feeM, channel) + (serverid ) * (2304./12.); 
-        }
-        else if( side(serverid) == 1 ) //SS
-        {
-          padphi = -M.getPad(feeM, channel) - (serverid-12) * (2304./12) ; 
-        }
-
-        int layer = M.getLayer(feeM, channel) + (serverid);
-        double phi = 0;
-
-        //double phi = M.getPhi(feeM, channel) + (serverid - 12*side(serverid)) * M_PI / 6 ;
-
-        if( side(serverid) == 0 ) //NS
-        {
-          phi = M.getPhi(feeM, channel) + (serverid ) * M_PI / 6 ; 
-        }
-        else if( side(serverid) == 1 ) //SS
-        {
-          phi = M.getPhi(feeM, channel) + (18 - serverid ) * M_PI / 6 ; 
-        }
+        // R, phi, layer, ... of this channel, precomputed in Init()
+        const ChannelGeometry &geo = m_Geometry[fee * N_CHANNEL + channel];
+        const double padphi = geo.padphi;
+        const int layer = geo.layer;
 
         //std::cout<<"Sector = "<< serverid <<" FEE = "<<fee<<" channel = "<<channel<<std::endl;
 
@@ -1076,10 +1036,10 @@ int TpcMon::process_event(Event *evt/* evt */)
 
             if((adc == max_of_previous_10 && checksumError == 0) && (parityError == 0 && is_channel_stuck == 0))//if the new value is greater than the previous 9
             {
-               MAXADC->Fill(adc - pedestal,Module_ID(fee)); 
-               if(Module_ID(fee)==0){MAXADC_1D_R1->Fill(adc - pedestal);} //Raw 1D for R1
-               else if(Module_ID(fee)==1){MAXADC_1D_R2->Fill(adc - pedestal);} //Raw 1D for R2
-               else if(Module_ID(fee)==2){MAXADC_1D_R3->Fill(adc - pedestal);} //Raw 1D for R3
+               MAXADC->Fill(adc - pedestal,geo.module); 
+               if(geo.module==0){MAXADC_1D_R1->Fill(adc - pedestal);} //Raw 1D for R1
+               else if(geo.module==1){MAXADC_1D_R2->Fill(adc - pedestal);} //Raw 1D for R2
+               else if(geo.module==2){MAXADC_1D_R3->Fill(adc - pedestal);} //Raw 1D for R3
             }
 
           }
@@ -1092,30 +1052,30 @@ int TpcMon::process_event(Event *evt/* evt */)
             PEDEST_SUB_ADC_vs_SAMPLE -> Fill(s, adc-pedestal);
             ADC_vs_SAMPLE_large -> Fill(s, adc);
 
-            if(Module_ID(fee)==0){RAWADC_1D_R1->Fill(adc);PEDEST_SUB_1D_R1->Fill(adc-pedestal);PEDEST_SUB_ADC_vs_SAMPLE_R1->Fill(s,adc-pedestal);} //Raw/pedest_sub 1D for R1
-            if(Module_ID(fee)==1){RAWADC_1D_R2->Fill(adc);PEDEST_SUB_1D_R2->Fill(adc-pedestal);PEDEST_SUB_ADC_vs_SAMPLE_R2->Fill(s,adc-pedestal);} //Raw/pedest_sub 1D for R2
-            if(Module_ID(fee)==2){RAWADC_1D_R3->Fill(adc);PEDEST_SUB_1D_R3->Fill(adc-pedestal);PEDEST_SUB_ADC_vs_SAMPLE_R3->Fill(s,adc-pedestal);} //Raw/pedest_sub 1D for R3
+            if(geo.module==0){RAWADC_1D_R1->Fill(adc);PEDEST_SUB_1D_R1->Fill(adc-pedestal);PEDEST_SUB_ADC_vs_SAMPLE_R1->Fill(s,adc-pedestal);} //Raw/pedest_sub 1D for R1
+            if(geo.module==1){RAWADC_1D_R2->Fill(adc);PEDEST_SUB_1D_R2->Fill(adc-pedestal);PEDEST_SUB_ADC_vs_SAMPLE_R2->Fill(s,adc-pedestal);} //Raw/pedest_sub 1D for R2
+            if(geo.module==2){RAWADC_1D_R3->Fill(adc);PEDEST_SUB_1D_R3->Fill(adc-pedestal);PEDEST_SUB_ADC_vs_SAMPLE_R3->Fill(s,adc-pedestal);} //Raw/pedest_sub 1D for R3
 
-            if(Module_ID(fee)==0 && ((adc-pedestal) > std::max(5.0*noise,20.)) && layer != 0){COUNTS_vs_SAMPLE_1D_R1->Fill(s);} //Drift window in R1
-	    if(Module_ID(fee)==1 && ((adc-pedestal) > std::max(5.0*noise,20.)) && layer != 0){COUNTS_vs_SAMPLE_1D_R2->Fill(s);} //Drift window in R2
-	    if(Module_ID(fee)==2 && ((adc-pedestal) > std::max(5.0*noise,20.)) && layer != 0){COUNTS_vs_SAMPLE_1D_R3->Fill(s);} //Drift window in R3
+            if(geo.module==0 && ((adc-pedestal) > std::max(5.0*noise,20.)) && layer != 0){COUNTS_vs_SAMPLE_1D_R1->Fill(s);} //Drift window in R1
+	    if(geo.module==1 && ((adc-pedestal) > std::max(5.0*noise,20.)) && layer != 0){COUNTS_vs_SAMPLE_1D_R2->Fill(s);} //Drift window in R2
+	    if(geo.module==2 && ((adc-pedestal) > std::max(5.0*noise,20.)) && layer != 0){COUNTS_vs_SAMPLE_1D_R3->Fill(s);} //Drift window in R3
 
-            //if(Module_ID(fee)==0 && (layer != 0)){COUNTS_vs_SAMPLE_1D_R1->Fill(s);} //Drift window in R1
-	    //if(Module_ID(fee)==1 && (layer != 0)){COUNTS_vs_SAMPLE_1D_R2->Fill(s);} //Drift window in R2
-	    //if(Module_ID(fee)==2 && (layer != 0)){COUNTS_vs_SAMPLE_1D_R3->Fill(s);} //Drift window in R3
+            //if(geo.module==0 && (layer != 0)){COUNTS_vs_SAMPLE_1D_R1->Fill(s);} //Drift window in R1
+	    //if(geo.module==1 && (layer != 0)){COUNTS_vs_SAMPLE_1D_R2->Fill(s);} //Drift window in R2
+	    //if(geo.module==2 && (layer != 0)){COUNTS_vs_SAMPLE_1D_R3->Fill(s);} //Drift window in R3
 
             if( (adc-pedestal) > 25 ){ num_samples_over_threshold++ ;}
           }
 
           //increment 
-          if(serverid >= 0 && serverid < 12 ){ North_Side_Arr[ Index_from_Module(serverid,fee) ] += adc;}
-          else {South_Side_Arr[ Index_from_Module(serverid,fee)-36 ] += adc;}
+          if(serverid >= 0 && serverid < 12 ){ North_Side_Arr[ geo.sidebin ] += adc;}
+          else {South_Side_Arr[ geo.sidebin ] += adc;}
 
 	  //std::cout<<"MADE IT TO END OF sample LOOP, "<<"current sample = "<<s<<", total sample = "<<nr_Samples<<" EVENT "<<evtcnt<<std::endl;
         } //nr samples
 
         //for streaker diagnostic:
-        if( num_samples_over_threshold > 15 ){ NStreaks_vs_EventNo->Fill(evtcnt); }
+        if( num_samples_over_threshold > 15 ){ OnlMonEventCounter::Fill(NStreaks_vs_EventNo, evtcnt); }
 
         //for complicated XY stuff ____________________________________________________
         //20 = 3-5 * sigma - hard-coded
@@ -1125,47 +1085,47 @@ int TpcMon::process_event(Event *evt/* evt */)
 
         if( (serverid < 12 && (pedest_sub_wf_max) > std::max(5.0*noise,20.)) && layer != 0 )
         {
-          if(Module_ID(fee)==0){NorthSideADC_clusterXY_R1->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max);NorthSideADC_clusterXY_R1_unw->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R1
-          else if(Module_ID(fee)==1){NorthSideADC_clusterXY_R2->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max);NorthSideADC_clusterXY_R2_unw->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R2
-          else if(Module_ID(fee)==2){NorthSideADC_clusterXY_R3->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max);NorthSideADC_clusterXY_R3_unw->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R3
+          if(geo.module==0){NorthSideADC_clusterXY_R1->Fill(geo.x,geo.y,pedest_sub_wf_max);NorthSideADC_clusterXY_R1_unw->Fill(geo.x,geo.y);} //Raw 1D for R1
+          else if(geo.module==1){NorthSideADC_clusterXY_R2->Fill(geo.x,geo.y,pedest_sub_wf_max);NorthSideADC_clusterXY_R2_unw->Fill(geo.x,geo.y);} //Raw 1D for R2
+          else if(geo.module==2){NorthSideADC_clusterXY_R3->Fill(geo.x,geo.y,pedest_sub_wf_max);NorthSideADC_clusterXY_R3_unw->Fill(geo.x,geo.y);} //Raw 1D for R3
 
-          if( t_max >= 10 && t_max <=255 ){z = 1030 - (t_max - 10)*(50 * 0.084);NorthSideADC_clusterZY->Fill(z,R*sin(phi),pedest_sub_wf_max);NorthSideADC_clusterZY_unw->Fill(z,R*sin(phi));}
+          if( t_max >= 10 && t_max <=255 ){z = 1030 - (t_max - 10)*(50 * 0.084);NorthSideADC_clusterZY->Fill(z,geo.y,pedest_sub_wf_max);NorthSideADC_clusterZY_unw->Fill(z,geo.y);}
         }
         else if( (serverid >=12 && (pedest_sub_wf_max) > std::max(5.0*noise,20.)) && layer != 0)
         {
-          if(Module_ID(fee)==0){SouthSideADC_clusterXY_R1->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max);SouthSideADC_clusterXY_R1_unw->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R1
-          else if(Module_ID(fee)==1){SouthSideADC_clusterXY_R2->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max);SouthSideADC_clusterXY_R2_unw->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R2
-          else if(Module_ID(fee)==2){SouthSideADC_clusterXY_R3->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max);SouthSideADC_clusterXY_R3_unw->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R3
+          if(geo.module==0){SouthSideADC_clusterXY_R1->Fill(geo.x,geo.y,pedest_sub_wf_max);SouthSideADC_clusterXY_R1_unw->Fill(geo.x,geo.y);} //Raw 1D for R1
+          else if(geo.module==1){SouthSideADC_clusterXY_R2->Fill(geo.x,geo.y,pedest_sub_wf_max);SouthSideADC_clusterXY_R2_unw->Fill(geo.x,geo.y);} //Raw 1D for R2
+          else if(geo.module==2){SouthSideADC_clusterXY_R3->Fill(geo.x,geo.y,pedest_sub_wf_max);SouthSideADC_clusterXY_R3_unw->Fill(geo.x,geo.y);} //Raw 1D for R3
 
-          if( t_max >= 10 && t_max <=255 ){z = -1030 + (t_max - 10)*(50 * 0.084);SouthSideADC_clusterZY->Fill(z,R*sin(phi),pedest_sub_wf_max);SouthSideADC_clusterZY_unw->Fill(z,R*sin(phi));}
+          if( t_max >= 10 && t_max <=255 ){z = -1030 + (t_max - 10)*(50 * 0.084);SouthSideADC_clusterZY->Fill(z,geo.y,pedest_sub_wf_max);SouthSideADC_clusterZY_unw->Fill(z,geo.y);}
         }
         //________________________________________________________________________________
         //XY laser peak
         if( (serverid < 12 && (pedest_sub_wf_max_laser_peak) > std::max(5.0*noise,20.)) && ((t_max > 410 && t_max < 422) && (layer != 0))) // only fill if the laser was the max
         {
-          if(Module_ID(fee)==0){NorthSideADC_clusterXY_R1_LASER->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max_laser_peak);} //Raw 1D for R1
-          else if(Module_ID(fee)==1){NorthSideADC_clusterXY_R2_LASER->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max_laser_peak);} //Raw 1D for R2
-          else if(Module_ID(fee)==2){NorthSideADC_clusterXY_R3_LASER->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max_laser_peak);} //Raw 1D for R3
+          if(geo.module==0){NorthSideADC_clusterXY_R1_LASER->Fill(geo.x,geo.y,pedest_sub_wf_max_laser_peak);} //Raw 1D for R1
+          else if(geo.module==1){NorthSideADC_clusterXY_R2_LASER->Fill(geo.x,geo.y,pedest_sub_wf_max_laser_peak);} //Raw 1D for R2
+          else if(geo.module==2){NorthSideADC_clusterXY_R3_LASER->Fill(geo.x,geo.y,pedest_sub_wf_max_laser_peak);} //Raw 1D for R3
         }
         else if( (serverid >=12 && (pedest_sub_wf_max_laser_peak) > std::max(5.0*noise,20.)) && ((t_max > 410 && t_max < 422) && (layer != 0))) // only fill if the laser was the max
         {
-          if(Module_ID(fee)==0){SouthSideADC_clusterXY_R1_LASER->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max_laser_peak);} //Raw 1D for R1
-          else if(Module_ID(fee)==1){SouthSideADC_clusterXY_R2_LASER->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max_laser_peak);} //Raw 1D for R2
-          else if(Module_ID(fee)==2){SouthSideADC_clusterXY_R3_LASER->Fill(R*cos(phi),R*sin(phi),pedest_sub_wf_max_laser_peak);} //Raw 1D for R3
+          if(geo.module==0){SouthSideADC_clusterXY_R1_LASER->Fill(geo.x,geo.y,pedest_sub_wf_max_laser_peak);} //Raw 1D for R1
+          else if(geo.module==1){SouthSideADC_clusterXY_R2_LASER->Fill(geo.x,geo.y,pedest_sub_wf_max_laser_peak);} //Raw 1D for R2
+          else if(geo.module==2){SouthSideADC_clusterXY_R3_LASER->Fill(geo.x,geo.y,pedest_sub_wf_max_laser_peak);} //Raw 1D for R3
         }
         //________________________________________________________________________________
         //5 event displays
         if( (serverid < 12 && (pedest_sub_wf_max) > std::max(5.0*noise,20.)) && layer != 0 )
         {
-          if(Module_ID(fee)==0){NorthSideADC_clusterXY_R1_u5->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R1
-          else if(Module_ID(fee)==1){NorthSideADC_clusterXY_R2_u5->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R2
-          else if(Module_ID(fee)==2){NorthSideADC_clusterXY_R3_u5->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R3
+          if(geo.module==0){NorthSideADC_clusterXY_R1_u5->Fill(geo.x,geo.y);} //Raw 1D for R1
+          else if(geo.module==1){NorthSideADC_clusterXY_R2_u5->Fill(geo.x,geo.y);} //Raw 1D for R2
+          else if(geo.module==2){NorthSideADC_clusterXY_R3_u5->Fill(geo.x,geo.y);} //Raw 1D for R3
         }
         if( (serverid >= 12 && (pedest_sub_wf_max) > std::max(5.0*noise,20.)) && layer != 0 )
         {
-          if(Module_ID(fee)==0){SouthSideADC_clusterXY_R1_u5->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R1
-          else if(Module_ID(fee)==1){SouthSideADC_clusterXY_R2_u5->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R2
-          else if(Module_ID(fee)==2){SouthSideADC_clusterXY_R3_u5->Fill(R*cos(phi),R*sin(phi));} //Raw 1D for R3
+          if(geo.module==0){SouthSideADC_clusterXY_R1_u5->Fill(geo.x,geo.y);} //Raw 1D for R1
+          else if(geo.module==1){SouthSideADC_clusterXY_R2_u5->Fill(geo.x,geo.y);} //Raw 1D for R2
+          else if(geo.module==2){SouthSideADC_clusterXY_R3_u5->Fill(geo.x,geo.y);} //Raw 1D for R3
         }
         //________________________________________________________________________________
 
@@ -1246,6 +1206,51 @@ int TpcMon::Module_ID(int fee_id) //for simply determining which module you are
 }
 
 
+void TpcMon::BuildGeometry()
+{
+  // clockwise FEE mapping
+  //int FEE_map[26]={5, 6, 1, 3, 2, 12, 10, 11, 9, 8, 7, 1, 2, 4, 8, 7, 6, 5, 4, 3, 1, 3, 2, 4, 6, 5};
+  const int FEE_R[N_FEE]={2, 2, 1, 1, 1, 3, 3, 3, 3, 3, 3, 2, 2, 1, 2, 2, 1, 1, 2, 2, 3, 3, 3, 3, 3, 3};
+  // counter clockwise FEE mapping (From Takao - DEPRECATED AS OF 08.29)
+  //int FEE_map[26]={3, 2, 5, 3, 4, 0, 2, 1, 3, 4, 5, 7, 6, 2, 0, 1, 0, 1, 4, 5, 11, 9, 10, 8, 6, 7};
+
+  // FEE mapping from Jin
+  const int FEE_map[N_FEE]={4, 5, 0, 2, 1, 11, 9, 10, 8, 7, 6, 0, 1, 3, 7, 6, 5, 4, 3, 2, 0, 2, 1, 3, 5, 4};
+
+  serverid = MonitorServerId();
+
+  m_Geometry.assign(N_FEE * N_CHANNEL, ChannelGeometry());
+  for (int fee = 0; fee < N_FEE; fee++)
+  {
+    // setting the mapp of the FEE
+    int feeM = FEE_map[fee];
+    if(FEE_R[fee]==2) feeM += 6;
+    if(FEE_R[fee]==3) feeM += 14;
+
+    for (int channel = 0; channel < N_CHANNEL; channel++)
+    {
+      ChannelGeometry &geo = m_Geometry[fee * N_CHANNEL + channel];
+      geo.R = M.getR(feeM, channel);
+      if( side(serverid) == 0 ) //NS
+      {
+        geo.padphi =  M.getPad(feeM, channel) + (serverid ) * (2304./12.);
+        geo.phi = M.getPhi(feeM, channel) + (serverid ) * M_PI / 6 ;
+      }
+      else if( side(serverid) == 1 ) //SS
+      {
+        geo.padphi = -M.getPad(feeM, channel) - (serverid-12) * (2304./12) ;
+        geo.phi = M.getPhi(feeM, channel) + (18 - serverid ) * M_PI / 6 ;
+      }
+      geo.layer = M.getLayer(feeM, channel) + (serverid);
+      geo.x = geo.R*cos(geo.phi);
+      geo.y = geo.R*sin(geo.phi);
+      geo.module = Module_ID(fee);
+      geo.sidebin = (serverid >= 0 && serverid < 12) ? Index_from_Module(serverid,fee) : Index_from_Module(serverid,fee)-36;
+    }
+  }
+  return;
+}
+
 int TpcMon::Index_from_Module(int sec_id, int fee_id) //for placing in the array (takes into account sector)
 {
   int mod_id;
@@ -142,6 +142,22 @@ class TpcMon : public OnlMon
 
   TpcMap M; //declare Martin's map
 
+  // geometry of one fee/channel of this sector, filled once in Init() by BuildGeometry()
+  static const int N_FEE = 26;
+  static const int N_CHANNEL = 256;
+  struct ChannelGeometry
+  {
+    double R = 0;
+    double phi = 0;
+    double padphi = 0;
+    double x = 0; // R*cos(phi)
+    double y = 0; // R*sin(phi)
+    int layer = 0;
+    int module = 0; // Module_ID(fee): 0 = R1, 1 = R2, 2 = R3
+    int sidebin = 0; // index into North_Side_Arr/South_Side_Arr
+  };
+  std::vector<ChannelGeometry> m_Geometry; // N_FEE*N_CHANNEL, index fee*N_CHANNEL + channel
+
   int starting_BCO;
   int rollover_value;
   int current_BCOBIN;
@@ -150,6 +166,7 @@ class TpcMon : public OnlMon
 
   int stuck_channel_count [256][26] = {0}; // array for counting # of times a unique channel get stuck
 
+  void BuildGeometry();
   void Locate(int id, float *rbin, float *thbin);
   int Index_from_Module(int sec_id, int fee_id);
   int Module_ID(int fee_id);
@@ -1,6 +1,7 @@
 #include "TpcMonDraw.h"
 
 #include <onlmon/OnlMonClient.h>
+#include <onlmon/OnlMonEventCounter.h>
 
 #include <TAxis.h>  // for TAxis
 #include <TCanvas.h>
@@ -22,6 +23,7 @@
 #include <TLine.h>
 #include <TEllipse.h>
 
+#include <algorithm>
 #include <cstring>  // for memset
 #include <ctime>
 #include <fstream>
@@ -42,6 +44,85 @@ TpcMonDraw::TpcMonDraw(const std::string &name)
 
 int TpcMonDraw::Init()
 {
+  // histograms each canvas needs, tpcDraw(what) fetches only those
+  AddMergedCanvasHisto("TPCMODULE", "NorthSideADC");
+  AddMergedCanvasHisto("TPCMODULE", "SouthSideADC");
+  AddCanvasHisto("TPCSAMPLESIZE", "sample_size_hist");
+  AddCanvasHisto("TPCSTUCKCHANNELS", "Stuck_Channels");
+  AddCanvasHisto("TPCCHECKSUMERROR", "Check_Sum_Error");
+  AddCanvasHisto("TPCCHECKSUMERROR", "Check_Sums");
+  AddCanvasHisto("TPCPARITYERROR", "Check_Sums");
+  AddCanvasHisto("TPCPARITYERROR", "Parity_Error");
+  AddCanvasHisto("TPCADCVSSAMPLE", "ADC_vs_SAMPLE");
+  AddCanvasHisto("TPCMAXADCMODULE", "MAXADC");
+  AddCanvasHisto("TPCRAWADC1D", "RAWADC_1D_R1");
+  AddCanvasHisto("TPCRAWADC1D", "RAWADC_1D_R2");
+  AddCanvasHisto("TPCRAWADC1D", "RAWADC_1D_R3");
+  AddCanvasHisto("TPCMAXADC1D", "MAXADC_1D_R1");
+  AddCanvasHisto("TPCMAXADC1D", "MAXADC_1D_R2");
+  AddCanvasHisto("TPCMAXADC1D", "MAXADC_1D_R3");
+  AddMergedCanvasHisto("TPCCLUSTERSXYWEIGTHED", "NorthSideADC_clusterXY_R1");
+  AddMergedCanvasHisto("TPCCLUSTERSXYWEIGTHED", "NorthSideADC_clusterXY_R2");
+  AddMergedCanvasHisto("TPCCLUSTERSXYWEIGTHED", "NorthSideADC_clusterXY_R3");
+  AddMergedCanvasHisto("TPCCLUSTERSXYWEIGTHED", "SouthSideADC_clusterXY_R1");
+  AddMergedCanvasHisto("TPCCLUSTERSXYWEIGTHED", "SouthSideADC_clusterXY_R2");
+  AddMergedCanvasHisto("TPCCLUSTERSXYWEIGTHED", "SouthSideADC_clusterXY_R3");
+  AddMergedCanvasHisto("TPCCLUSTERSXYUNWEIGTHED", "NorthSideADC_clusterXY_R1_unw");
+  AddMergedCanvasHisto("TPCCLUSTERSXYUNWEIGTHED", "NorthSideADC_clusterXY_R2_unw");
+  AddMergedCanvasHisto("TPCCLUSTERSXYUNWEIGTHED", "NorthSideADC_clusterXY_R3_unw");
+  AddMergedCanvasHisto("TPCCLUSTERSXYUNWEIGTHED", "SouthSideADC_clusterXY_R1_unw");
+  AddMergedCanvasHisto("TPCCLUSTERSXYUNWEIGTHED", "SouthSideADC_clusterXY_R2_unw");
+  AddMergedCanvasHisto("TPCCLUSTERSXYUNWEIGTHED", "SouthSideADC_clusterXY_R3_unw");
+  AddCanvasHisto("TPCADCVSSAMPLELARGE", "ADC_vs_SAMPLE_large");
+  AddMergedCanvasHisto("TPCCLUSTERSZYWEIGTHED", "NorthSideADC_clusterZY");
+  AddMergedCanvasHisto("TPCCLUSTERSZYWEIGTHED", "SouthSideADC_clusterZY");
+  AddMergedCanvasHisto("TPCCLUSTERSZYUNWEIGTHED", "NorthSideADC_clusterZY_unw");
+  AddMergedCanvasHisto("TPCCLUSTERSZYUNWEIGTHED", "SouthSideADC_clusterZY_unw");
+  AddCanvasHisto("TPCCHANNELPHI_LAYER_WEIGHTED", "Layer_ChannelPhi_ADC_weighted");
+  AddCanvasHisto("TPCPEDESTSUBADC1D", "PEDEST_SUB_1D_R1");
+  AddCanvasHisto("TPCPEDESTSUBADC1D", "PEDEST_SUB_1D_R2");
+  AddCanvasHisto("TPCPEDESTSUBADC1D", "PEDEST_SUB_1D_R3");
+  AddCanvasHisto("TPCNEVENTSEBDC", "NEvents_vs_EBDC");
+  AddCanvasHisto("TPCPEDESTSUBADCVSSAMPLE", "PEDEST_SUB_ADC_vs_SAMPLE");
+  AddCanvasHisto("TPCPEDESTSUBADCVSSAMPLE_R1", "PEDEST_SUB_ADC_vs_SAMPLE_R1");
+  AddCanvasHisto("TPCPEDESTSUBADCVSSAMPLE_R2", "PEDEST_SUB_ADC_vs_SAMPLE_R2");
+  AddCanvasHisto("TPCPEDESTSUBADCVSSAMPLE_R3", "PEDEST_SUB_ADC_vs_SAMPLE_R3");
+  AddMergedCanvasHisto("TPCLASERCLUSTERSXYWEIGTHED", "NorthSideADC_clusterXY_R1_LASER");
+  AddMergedCanvasHisto("TPCLASERCLUSTERSXYWEIGTHED", "NorthSideADC_clusterXY_R2_LASER");
+  AddMergedCanvasHisto("TPCLASERCLUSTERSXYWEIGTHED", "NorthSideADC_clusterXY_R3_LASER");
+  AddMergedCanvasHisto("TPCLASERCLUSTERSXYWEIGTHED", "SouthSideADC_clusterXY_R1_LASER");
+  AddMergedCanvasHisto("TPCLASERCLUSTERSXYWEIGTHED", "SouthSideADC_clusterXY_R2_LASER");
+  AddMergedCanvasHisto("TPCLASERCLUSTERSXYWEIGTHED", "SouthSideADC_clusterXY_R3_LASER");
+  AddMergedCanvasHisto("TPCCLUSTERS5EXYUNWEIGTHED", "NorthSideADC_clusterXY_R1_u5");
+  AddMergedCanvasHisto("TPCCLUSTERS5EXYUNWEIGTHED", "NorthSideADC_clusterXY_R2_u5");
+  AddMergedCanvasHisto("TPCCLUSTERS5EXYUNWEIGTHED", "NorthSideADC_clusterXY_R3_u5");
+  AddMergedCanvasHisto("TPCCLUSTERS5EXYUNWEIGTHED", "SouthSideADC_clusterXY_R1_u5");
+  AddMergedCanvasHisto("TPCCLUSTERS5EXYUNWEIGTHED", "SouthSideADC_clusterXY_R2_u5");
+  AddMergedCanvasHisto("TPCCLUSTERS5EXYUNWEIGTHED", "SouthSideADC_clusterXY_R3_u5");
+  AddCanvasHisto("TPCCHANSINPACKETNS", "Channels_Always");
+  AddCanvasHisto("TPCCHANSINPACKETNS", "Channels_in_Packet");
+  AddCanvasHisto("TPCCHANSINPACKETSS", "Channels_Always");
+  AddCanvasHisto("TPCCHANSINPACKETSS", "Channels_in_Packet");
+  AddCanvasHisto("TPCCHANSPERLVL1NS", "Channels_in_Packet");
+  AddCanvasHisto("TPCCHANSPERLVL1NS", "LVL_1_TAGGER_per_EBDC");
+  AddCanvasHisto("TPCCHANSPERLVL1SS", "Channels_in_Packet");
+  AddCanvasHisto("TPCCHANSPERLVL1SS", "LVL_1_TAGGER_per_EBDC");
+  AddCanvasHisto("TPCNONZSCHANNELS", "Num_non_ZS_channels_vs_SAMPA");
+  AddCanvasHisto("TPCZSTRIGGERADCVSSAMPLE", "ZS_Trigger_ADC_vs_Sample");
+  AddCanvasHisto("TPCFIRSTNONZSADCVSFIRSTNONZSSAMPLE", "First_ADC_vs_First_Time_Bin");
+  AddCanvasHisto("TPCDRIFTWINDOW", "COUNTS_vs_SAMPLE_1D_R1");
+  AddCanvasHisto("TPCDRIFTWINDOW", "COUNTS_vs_SAMPLE_1D_R2");
+  AddCanvasHisto("TPCDRIFTWINDOW", "COUNTS_vs_SAMPLE_1D_R3");
+  AddCanvasHisto("SERVERSTATS", "FrameWorkVars");
+  AddCanvasHisto("TPCNSTREAKERSVSEVENTNO", "NEvents_vs_EBDC");
+  AddCanvasHisto("TPCNSTREAKERSVSEVENTNO", "NStreaks_vs_EventNo");
+  AddCanvasHisto("TPCPACKETYPEFRACTION", "Packet_Type_Fraction_ELSE");
+  AddCanvasHisto("TPCPACKETYPEFRACTION", "Packet_Type_Fraction_HB");
+  AddCanvasHisto("TPCPACKETYPEFRACTION", "Packet_Type_Fraction_NORM");
+  AddCanvasHisto("SHIFTER_DRIFT_PLOT", "COUNTS_vs_SAMPLE_1D_R1");
+  AddCanvasHisto("SHIFTER_DRIFT_PLOT", "COUNTS_vs_SAMPLE_1D_R2");
+  AddCanvasHisto("SHIFTER_DRIFT_PLOT", "COUNTS_vs_SAMPLE_1D_R3");
+  AddCanvasHisto("SHIFTER_DRIFT_PLOT", "NEvents_vs_EBDC");
   return 0;
 }
 
@@ -633,15 +714,10 @@ int TpcMonDraw::DrawTPCModules(const std::string & /* what */)
   TH2 *tpcmon_NSIDEADC[24] = {nullptr};
   TH2 *tpcmon_SSIDEADC[24] = {nullptr};
 
-  char TPCMON_STR[100];
-  // TPC ADC pie chart
-  for( int i=0; i<24; i++ ) 
-  {
-    //const TString TPCMON_STR( Form( "TPCMON_%i", i ) );
-    sprintf(TPCMON_STR,"TPCMON_%i",i);
-    tpcmon_NSIDEADC[i] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC");
-    tpcmon_SSIDEADC[i] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC");
-  }
+  // sum over the sectors, the servers 0-11 fill the north side, 12-23 the south side
+  // (read from the TPCMON aggregator when it runs)
+  tpcmon_NSIDEADC[0] = (TH2*) getMergedHisto("NorthSideADC");
+  tpcmon_SSIDEADC[12] = (TH2*) getMergedHisto("SouthSideADC");
 
 
   //TH2 *tpcmon_NSIDEADC1 = (TH2*) cl->getHisto("TPCMON_0","NorthSideADC");
@@ -1294,19 +1370,13 @@ int TpcMonDraw::DrawTPCXYclusters(const std::string & /* what */)
   TEllipse *e4 = new TEllipse(0.0,0.0,759.11,759.11);
   //__________________
 
-  char TPCMON_STR[100];
-  for( int i=0; i<24; i++ ) 
-  {
-    //const TString TPCMON_STR( Form( "TPCMON_%i", i ) );
-    sprintf(TPCMON_STR,"TPCMON_%i",i);
-    tpcmon_NSTPC_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R1");
-    tpcmon_NSTPC_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R2");
-    tpcmon_NSTPC_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R3");
-
-    tpcmon_SSTPC_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R1");
-    tpcmon_SSTPC_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R2");
-    tpcmon_SSTPC_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R3");
-  }
+  // summed over the sectors (see DrawTPCModules)
+  tpcmon_NSTPC_clusXY[0][0] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R1");
+  tpcmon_NSTPC_clusXY[0][1] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R2");
+  tpcmon_NSTPC_clusXY[0][2] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R3");
+  tpcmon_SSTPC_clusXY[12][0] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R1");
+  tpcmon_SSTPC_clusXY[12][1] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R2");
+  tpcmon_SSTPC_clusXY[12][2] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R3");
 
   if (!gROOT->FindObject("TPCClusterXY"))
   {
@@ -1466,19 +1536,13 @@ int TpcMonDraw::DrawTPCXYclusters_unweighted(const std::string & /* what */)
   TEllipse *e4 = new TEllipse(0.0,0.0,759.11,759.11);
   //__________________
 
-  char TPCMON_STR[100];
-  for( int i=0; i<24; i++ ) 
-  {
-    //const TString TPCMON_STR( Form( "TPCMON_%i", i ) );
-    sprintf(TPCMON_STR,"TPCMON_%i",i);
-    tpcmon_NSTPC_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R1_unw");
-    tpcmon_NSTPC_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R2_unw");
-    tpcmon_NSTPC_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R3_unw");
-
-    tpcmon_SSTPC_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R1_unw");
-    tpcmon_SSTPC_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R2_unw");
-    tpcmon_SSTPC_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R3_unw");
-  }
+  // summed over the sectors (see DrawTPCModules)
+  tpcmon_NSTPC_clusXY[0][0] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R1_unw");
+  tpcmon_NSTPC_clusXY[0][1] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R2_unw");
+  tpcmon_NSTPC_clusXY[0][2] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R3_unw");
+  tpcmon_SSTPC_clusXY[12][0] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R1_unw");
+  tpcmon_SSTPC_clusXY[12][1] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R2_unw");
+  tpcmon_SSTPC_clusXY[12][2] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R3_unw");
 
   if (!gROOT->FindObject("TPCClusterXY_unw"))
   {
@@ -1673,15 +1737,9 @@ int TpcMonDraw::DrawTPCZYclusters(const std::string & /* what */)
   dummy_his1_ZY->SetXTitle("Z [mm]");
   dummy_his1_ZY->SetYTitle("Y [mm]");
 
-  char TPCMON_STR[100];
-  for( int i=0; i<24; i++ ) 
-  {
-    //const TString TPCMON_STR( Form( "TPCMON_%i", i ) );
-    sprintf(TPCMON_STR,"TPCMON_%i",i);
-    tpcmon_NSTPC_clusZY[i] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterZY");
-
-    tpcmon_SSTPC_clusZY[i] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterZY");
-  }
+  // summed over the sectors (see DrawTPCModules)
+  tpcmon_NSTPC_clusZY[0] = (TH2*) getMergedHisto("NorthSideADC_clusterZY");
+  tpcmon_SSTPC_clusZY[12] = (TH2*) getMergedHisto("SouthSideADC_clusterZY");
 
   if (!gROOT->FindObject("TPCClusterZY"))
   {
@@ -1775,15 +1833,9 @@ int TpcMonDraw::DrawTPCZYclusters_unweighted(const std::string & /* what */)
   dummy_his1_ZY_unw->SetXTitle("Z [mm]");
   dummy_his1_ZY_unw->SetYTitle("Y [mm]");
 
-  char TPCMON_STR[100];
-  for( int i=0; i<24; i++ ) 
-  {
-    //const TString TPCMON_STR( Form( "TPCMON_%i", i ) );
-    sprintf(TPCMON_STR,"TPCMON_%i",i);
-    tpcmon_NSTPC_clusZY_unw[i] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterZY_unw");
-
-    tpcmon_SSTPC_clusZY_unw[i] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterZY_unw");
-  }
+  // summed over the sectors (see DrawTPCModules)
+  tpcmon_NSTPC_clusZY_unw[0] = (TH2*) getMergedHisto("NorthSideADC_clusterZY_unw");
+  tpcmon_SSTPC_clusZY_unw[12] = (TH2*) getMergedHisto("SouthSideADC_clusterZY_unw");
 
   if (!gROOT->FindObject("TPCClusterZY_unw"))
   {
@@ -2378,19 +2430,13 @@ int TpcMonDraw::DrawTPCXYlaserclusters(const std::string & /* what */)
   TEllipse *e4 = new TEllipse(0.0,0.0,759.11,759.11);
   //__________________
 
-  char TPCMON_STR[100];
-  for( int i=0; i<24; i++ ) 
-  {
-    //const TString TPCMON_STR( Form( "TPCMON_%i", i ) );
-    sprintf(TPCMON_STR,"TPCMON_%i",i);
-    tpcmon_NSTPC_laser_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R1_LASER");
-    tpcmon_NSTPC_laser_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R2_LASER");
-    tpcmon_NSTPC_laser_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R3_LASER");
-
-    tpcmon_SSTPC_laser_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R1_LASER");
-    tpcmon_SSTPC_laser_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R2_LASER");
-    tpcmon_SSTPC_laser_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R3_LASER");
-  }
+  // summed over the sectors (see DrawTPCModules)
+  tpcmon_NSTPC_laser_clusXY[0][0] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R1_LASER");
+  tpcmon_NSTPC_laser_clusXY[0][1] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R2_LASER");
+  tpcmon_NSTPC_laser_clusXY[0][2] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R3_LASER");
+  tpcmon_SSTPC_laser_clusXY[12][0] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R1_LASER");
+  tpcmon_SSTPC_laser_clusXY[12][1] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R2_LASER");
+  tpcmon_SSTPC_laser_clusXY[12][2] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R3_LASER");
 
   if (!gROOT->FindObject("TPCClusterXY_laser"))
   {
@@ -2648,19 +2694,13 @@ int TpcMonDraw::DrawTPCXYclusters5event(const std::string & /* what */)
   TEllipse *e4 = new TEllipse(0.0,0.0,759.11,759.11);
   //__________________
 
-  char TPCMON_STR[100];
-  for( int i=0; i<24; i++ ) 
-  {
-    //const TString TPCMON_STR( Form( "TPCMON_%i", i ) );
-    sprintf(TPCMON_STR,"TPCMON_%i",i);                             
-    tpcmon_NSTPC_5e_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R1_u5");
-    tpcmon_NSTPC_5e_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R2_u5");
-    tpcmon_NSTPC_5e_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"NorthSideADC_clusterXY_R3_u5");
-
-    tpcmon_SSTPC_5e_clusXY[i][0] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R1_u5");
-    tpcmon_SSTPC_5e_clusXY[i][1] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R2_u5");
-    tpcmon_SSTPC_5e_clusXY[i][2] = (TH2*) cl->getHisto(TPCMON_STR,"SouthSideADC_clusterXY_R3_u5");
-  }
+  // summed over the sectors (see DrawTPCModules)
+  tpcmon_NSTPC_5e_clusXY[0][0] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R1_u5");
+  tpcmon_NSTPC_5e_clusXY[0][1] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R2_u5");
+  tpcmon_NSTPC_5e_clusXY[0][2] = (TH2*) getMergedHisto("NorthSideADC_clusterXY_R3_u5");
+  tpcmon_SSTPC_5e_clusXY[12][0] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R1_u5");
+  tpcmon_SSTPC_5e_clusXY[12][1] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R2_u5");
+  tpcmon_SSTPC_5e_clusXY[12][2] = (TH2*) getMergedHisto("SouthSideADC_clusterXY_R3_u5");
 
   if (!gROOT->FindObject("TPCClusterXY_u5"))
   {
@@ -3340,6 +3380,35 @@ int TpcMonDraw::DrawTPCNStreaksvsEventNo(const std::string & /* what */)
     }
   }
 
+  // the servers send sparse (event #, count) lists, render them over the events seen so far
+  for ( int i=0; i< 24; i++ )
+  {
+    if( tpcmon_NStreak_vsEventNo[i] && OnlMonEventCounter::LastEvent(tpcmon_NStreak_vsEventNo[i]) > event_max ){event_max = OnlMonEventCounter::LastEvent(tpcmon_NStreak_vsEventNo[i]);}
+  }
+  const int nbins_dense = std::min(event_max + 1, 10000); // one bin per event for short runs
+  for ( int i=0; i< 24; i++ )
+  {
+    if( !tpcmon_NStreak_vsEventNo[i] ){ continue; }
+    if( !NStreaks_vs_EventNo_dense[i] )
+    {
+      NStreaks_vs_EventNo_dense[i] = new TH1F(Form("NStreaks_vs_EventNo_dense_%i",i),"",nbins_dense,-0.5,event_max+0.5);
+      NStreaks_vs_EventNo_dense[i]->SetDirectory(nullptr);
+      NStreaks_vs_EventNo_dense[i]->SetXTitle("Event #");
+      NStreaks_vs_EventNo_dense[i]->SetYTitle("Number of horizontal streak channels");
+      NStreaks_vs_EventNo_dense[i] -> GetXaxis() -> SetLabelSize(0.05);
+      NStreaks_vs_EventNo_dense[i] -> GetXaxis() -> SetTitleSize(0.05);
+      NStreaks_vs_EventNo_dense[i] -> GetYaxis() -> SetLabelSize(0.05);
+      NStreaks_vs_EventNo_dense[i] -> GetYaxis() -> SetTitleSize(0.05);
+      NStreaks_vs_EventNo_dense[i] -> GetYaxis() -> SetTitleOffset(1.0);
+    }
+    else
+    {
+      NStreaks_vs_EventNo_dense[i]->SetBins(nbins_dense,-0.5,event_max+0.5);
+    }
+    OnlMonEventCounter::Render(tpcmon_NStreak_vsEventNo[i],NStreaks_vs_EventNo_dense[i]);
+    tpcmon_NStreak_vsEventNo[i] = NStreaks_vs_EventNo_dense[i];
+  }
+
 
   int line_colors[24] = { 3, 8, 2, 6, 46, 14, 1, 39, 38, 4, 7, 30, 3, 8, 6, 2, 46, 4, 1, 39, 38, 4, 7, 30 }; // assumed filling down and across
   //int line_colors_leg[24] = {2, 3, 38, 14, 6, 8, 4, 1, 46, 30, 7, 39, 6, 3, 38, 4, 2, 8, 4, 1, 46, 30, 7, 39 }; // assumed filling across and down
@@ -88,6 +88,8 @@ class TpcMonDraw : public OnlMonDraw
 
   TH2 *dummy_his1_ZY_unw = nullptr;
 
+  TH1 *NStreaks_vs_EventNo_dense[24] = {nullptr}; // rendered from the sparse server histograms
+
   TH2 *dummy_his1_channelphi_layer_w = nullptr;
   TH1 *dummy_his1_NEvents_EBDC = nullptr;
 
@@ -244,6 +244,21 @@ int TpotMon::Init()
 
   }
 
+  // flat fee id lookup table, to avoid map searches in the waveform loop
+  for( const auto& fee_id:fee_id_list )
+  {
+    if( fee_id < 0 ) continue;
+    if( fee_id >= int(m_fee_data.size()) ) m_fee_data.resize( fee_id+1 );
+
+    auto& fee_data = m_fee_data[fee_id];
+    fee_data.m_histograms = &m_detector_histograms.at(fee_id);
+    fee_data.m_tile_center = m_tile_centers.at(fee_id);
+    fee_data.m_segmentation = MicromegasDefs::getSegmentationType( m_mapping.get_hitsetkey(fee_id));
+    fee_data.m_strip_index.resize( MicromegasDefs::m_nchannels_fee );
+    for( int channel = 0; channel < MicromegasDefs::m_nchannels_fee; ++channel )
+    { fee_data.m_strip_index[channel] = m_mapping.get_physical_strip(fee_id, channel ); }
+  }
+
   // use monitor name for db table name
   Reset();
   return 0;
@@ -277,8 +292,9 @@ int TpotMon::process_event(Event* event)
 
   increment( m_counters, TpotMonDefs::kValidEventCounter );
 
-  // hit multiplicity vs fee id
-  std::map<int, int> multiplicity;
+  // reset hit multiplicity
+  for( auto& fee_data:m_fee_data )
+  { fee_data.m_multiplicity = 0; }
 
   // read the data
   for( const auto& packet_id:MicromegasDefs::m_packet_ids )
@@ -344,17 +360,17 @@ int TpotMon::process_event(Event* event)
       // account for fiber swapping
       const int fee_id = packet->iValue(i, "FEE");
 
-      // get detector index from fee id
-      const auto iter = m_detector_histograms.find( fee_id );
-      if( iter == m_detector_histograms.end() )
+      // get detector data from fee id
+      if( fee_id < 0 || fee_id >= int(m_fee_data.size()) || !m_fee_data[fee_id].m_histograms )
       {
         std::cout << "TpotMon::process_event - invalid fee_id: " << fee_id << std::endl;
         continue;
       }
-      const auto& detector_histograms = iter->second;
+      auto& fee_data = m_fee_data[fee_id];
+      const auto& detector_histograms = *fee_data.m_histograms;
 
       // strip
-      const auto strip_index = m_mapping.get_physical_strip(fee_id, channel );
+      const auto strip_index = fee_data.m_strip_index[channel];
 
       // heartbeat hits
       if( type == MicromegasDefs::HEARTBEAT_T )
@@ -367,23 +383,28 @@ int TpotMon::process_event(Event* event)
       // get channel rms and pedestal from calibration data
       const double pedestal = m_calibration_data.get_pedestal( fee_id, channel );
       const double rms = m_calibration_data.get_rms( fee_id, channel );
-
+      const double threshold = pedestal+m_n_sigma*rms;
 
       // get tile center, segmentation
-      const auto& [tile_x, tile_y]  = m_tile_centers.at(fee_id);
-      const auto segmentation = MicromegasDefs::getSegmentationType( m_mapping.get_hitsetkey(fee_id));
-
+      const auto& [tile_x, tile_y]  = fee_data.m_tile_center;
+      const auto segmentation = fee_data.m_segmentation;
 
       // fill 2D histograms ADC vs sample and hit charge vs sample
+      // and define if hit is signal, in a single pass over the samples
+      bool is_signal = false;
       const int samples = packet->iValue( i, "SAMPLES" );
       for( int is = 0; is < samples; ++is )
       {
         const uint16_t adc =  packet->iValue( i, is );
         if( adc == MicromegasDefs::m_adc_invalid ) continue;
-        const bool is_signal = rms>0 && (adc > m_min_adc) && (adc> pedestal+m_n_sigma*rms);
-        if( is_signal ) 
-	  {detector_histograms.m_counts_sample->Fill( is ); 
-	  detector_histograms.m_sample_channel->Fill( strip_index, is);}
+        const bool is_signal_sample = rms>0 && (adc > m_min_adc) && (adc > threshold);
+        if( is_signal_sample )
+        {
+          detector_histograms.m_counts_sample->Fill( is );
+          detector_histograms.m_sample_channel->Fill( strip_index, is);
+          if( is >= m_sample_window_signal.first && is < m_sample_window_signal.second )
+          { is_signal = true; }
+        }
         detector_histograms.m_adc_sample->Fill( is, adc );
         detector_histograms.m_hit_charge->Fill( adc );
 
@@ -394,26 +415,13 @@ int TpotMon::process_event(Event* event)
       // fill waveform profile for this channel
       detector_histograms.m_wf_vs_channel->Fill( strip_index );
 
-      // define if hit is signal
-      bool is_signal = false;
-      for( int is = std::max<int>(0,m_sample_window_signal.first); is < std::min<int>(samples,m_sample_window_signal.second); ++is )
-      {
-        const uint16_t adc =  packet->iValue( i, is );
-        if( adc == MicromegasDefs::m_adc_invalid ) continue;
-        if( rms>0 && (adc > m_min_adc) && (adc>pedestal + m_n_sigma*rms) )
-        {
-          is_signal = true;
-          break;
-        }
-      }
-
       // fill hit profile for this channel
       if( is_signal )
       {
         detector_histograms.m_hit_vs_channel->Fill( strip_index );
 
         // update multiplicity for this detector
-        ++multiplicity[fee_id];
+        ++fee_data.m_multiplicity;
 
         // fill detector multiplicity
         switch( segmentation )
@@ -433,8 +441,11 @@ int TpotMon::process_event(Event* event)
   }
 
   // fill hit multiplicities
-  for( auto&& [fee_id, detector_histograms]:m_detector_histograms )
-  { detector_histograms.m_hit_multiplicity->Fill( multiplicity[fee_id] ); }
+  for( const auto& fee_data:m_fee_data )
+  {
+    if( fee_data.m_histograms )
+    { fee_data.m_histograms->m_hit_multiplicity->Fill( fee_data.m_multiplicity ); }
+  }
 
   // convert multiplicity histogram into occupancy
   auto copy_content = []( TH2Poly* source, TH2Poly* destination, double scale )
@@ -10,6 +10,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 class Event;
 class TH1;
@@ -153,6 +154,32 @@ class TpotMon : public OnlMon
   //@name map detector histograms to fee id
   std::map<int, detector_histograms_t> m_detector_histograms;
 
+  //@name everything the waveform loop needs for a given fee, built once in Init
+  //@{
+  class fee_data_t
+  {
+    public:
+
+    /// detector histograms (owned by m_detector_histograms), nullptr for fee ids not in the mapping
+    detector_histograms_t* m_histograms = nullptr;
+
+    /// tile center
+    MicromegasGeometry::point_t m_tile_center = {0, 0};
+
+    /// segmentation
+    MicromegasDefs::SegmentationType m_segmentation = MicromegasDefs::SegmentationType::SEGMENTATION_PHI;
+
+    /// physical strip vs channel
+    std::vector<int> m_strip_index;
+
+    /// number of signal hits in current event
+    int m_multiplicity = 0;
+  };
+  //@}
+
+  //@name fee data, indexed by fee id
+  std::vector<fee_data_t> m_fee_data;
+
 };
 
 #endif /* TPOT_TPOTMON_H */
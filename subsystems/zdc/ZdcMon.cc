@@ -6,12 +6,12 @@
 #include "ZdcMon.h"
 
 #include <onlmon/OnlMon.h>  // for OnlMon
+#include <onlmon/CaloPacketDecoder.h>
 #include <onlmon/OnlMonDB.h>
 #include <onlmon/OnlMonServer.h>
 
 #include <Event/msg_profile.h>
 #include <calobase/TowerInfoDefs.h>
-#include <caloreco/CaloWaveformFitting.h>
 
 #include <Event/Event.h>
 #include <Event/EventTypes.h>
@@ -46,6 +46,7 @@ ZdcMon::ZdcMon(const std::string &name)
 ZdcMon::~ZdcMon()
 {
   // you can delete NULL pointers it results in a NOOP (No Operation)
+  delete caloDecoder;
   return;
 }
 
@@ -266,7 +267,8 @@ int ZdcMon::Init()
   se->registerHisto(this, smd_xy_north);
   se->registerHisto(this, smd_xy_south);
 
-  WaveformProcessingFast = new CaloWaveformFitting();
+  caloDecoder = new CaloPacketDecoder();
+  caloDecoder->SuppressedAsPrePost(false);  // fit the samples of suppressed channels as before
 
   Reset();
 
@@ -281,26 +283,6 @@ int ZdcMon::BeginRun(const int /* runno */)
   return 0;
 }
 
-std::vector<float> ZdcMon::anaWaveformFast(Packet *p, const int channel)
-{
-  std::vector<float> waveform;
-  // Chris: preallocation = speed improvement
-  waveform.reserve(p->iValue(0, "SAMPLES"));
-  for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
-  {
-    waveform.push_back(p->iValue(s, channel));
-  }
-  std::vector<std::vector<float>> multiple_wfs;
-  multiple_wfs.push_back(waveform);
-
-  std::vector<std::vector<float>> fitresults_zdc;
-  fitresults_zdc = WaveformProcessingFast->calo_processing_fast(multiple_wfs);
-
-  std::vector<float> result;
-  result = fitresults_zdc.at(0);
-  return result;
-}
-
 int ZdcMon::process_event(Event *e /* evt */)
 {
   evtcnt++;
@@ -332,9 +314,6 @@ int ZdcMon::process_event(Event *e /* evt */)
   std::vector <float> tsmd;
   tsmd.clear();
     
-  std::vector<float> resultFast;
-  resultFast.clear();
-
   float zdctimelow  = 5.0;
   float zdctimehigh  = 9.0;
     
@@ -353,40 +332,43 @@ int ZdcMon::process_event(Event *e /* evt */)
   Packet *p = e->getPacket(packet);
   if (p)
   {
-        
-    for (int c = 0; c < p->iValue(0, "CHANNELS"); c++)
+    int nChannels = caloDecoder->Decode(p);
+    int nSamples = caloDecoder->getNSamples();
+    caloDecoder->FitFast();  // fast waveform fitting of the whole packet
+    for (int c = 0; c < nChannels; c++)
     {
-      resultFast = anaWaveformFast(p, c);  // fast waveform fitting
-      float signalFast = resultFast.at(0);
-      float time = resultFast.at(1);
-      float pedestal = resultFast.at(2);
+      const CaloFastFit &resultFast = caloDecoder->getFit(c);
+      float signalFast = resultFast.amplitude;
+      float time = resultFast.time;
+      float pedestal = resultFast.pedestal;
       float signal = signalFast;
+      const float *waveform = caloDecoder->getWaveform(c);
         
-        for (int s = 0; s < p->iValue(0, "SAMPLES"); s++)
+        for (int s = 0; s < nSamples; s++)
         {
             if (c < 16)
             {
-                if (signal > waveform_hit_threshold) h_waveformZDC->Fill(s, p->iValue(s, c) - pedestal);
+                if (signal > waveform_hit_threshold) h_waveformZDC->Fill(s, waveform[s] - pedestal);
             }
             
             if (c > 15 && c < 18)
             {
-                if (signal > waveform_hit_threshold) h_waveformVeto_North->Fill(s, p->iValue(s, c) - pedestal);
+                if (signal > waveform_hit_threshold) h_waveformVeto_North->Fill(s, waveform[s] - pedestal);
             }
             
             if (c > 47 && c < 64)
             {
-                if (signal > waveform_hit_threshold) h_waveformSMD_North->Fill(s, p->iValue(s, c) - pedestal);
+                if (signal > waveform_hit_threshold) h_waveformSMD_North->Fill(s, waveform[s] - pedestal);
             }
             
             if (c > 79 && c < 82)
             {
-                if (signal > waveform_hit_threshold) h_waveformVeto_South->Fill(s, p->iValue(s, c) - pedestal);
+                if (signal > waveform_hit_threshold) h_waveformVeto_South->Fill(s, waveform[s] - pedestal);
             }
             
             if (c > 111)
             {
-                if (signal > waveform_hit_threshold) h_waveformSMD_South->Fill(s, p->iValue(s, c) - pedestal);
+                if (signal > waveform_hit_threshold) h_waveformSMD_South->Fill(s, waveform[s] - pedestal);
             }
         }
 
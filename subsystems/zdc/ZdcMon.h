@@ -7,7 +7,7 @@
 #include <cmath>
 #include <vector>
 
-class CaloWaveformFitting;
+class CaloPacketDecoder;
 class TowerInfoContainer;
 class Event;
 class TH1;
@@ -28,8 +28,7 @@ class ZdcMon : public OnlMon
   
 
  protected:
-  std::vector<float> anaWaveformFast(Packet *p, const int channel);
-  CaloWaveformFitting *WaveformProcessingFast = nullptr;
+  CaloPacketDecoder *caloDecoder = nullptr;
 
   double PI = 3.14159;
   int evtcnt = 0;